@@ -0,0 +1,74 @@
+"""Side-by-side kernel_bench results of two firmware builds (e.g. Arm vs RISC-V,
+or MINDWRITE_SRAM_PLACEMENT ON vs OFF).
+
+Build with -DMINDWRITE_BENCH=ON once per variant, capture each boot log, then:
+
+    python bench_compare.py arm.log riscv.log
+
+For the placement A/B, build both with -DMINDWRITE_BENCH=ON and only
+-DMINDWRITE_SRAM_PLACEMENT=OFF / ON differing, flash each and save its log:
+
+    python bench_compare.py flash.log sram.log
+
+The *_cold rows are the ones to read there: warm runs execute from the XIP
+cache in both builds.
+
+Reads the "bench arch: ..." and "bench <name>: <us> us" lines and prints one row
+per kernel with both times and the ratio (second / first; < 1 = second is faster).
+Kernels whose correctness check failed in either log are listed first.
+"""
+import argparse
+import re
+
+_LINE = re.compile(r"bench (\S+): (\d+) us")
+_ARCH = re.compile(r"bench arch: (\S+)")
+_FAIL = re.compile(r"check (\S+): FAIL")
+
+
+def read_log(path):
+    arch = path
+    times = {}
+    failed = []
+    with open(path, errors="replace") as f:
+        for line in f:
+            m = _FAIL.search(line)
+            if m:
+                failed.append(m.group(1))
+                continue
+            m = _ARCH.search(line)
+            if m:
+                arch = m.group(1)
+                continue
+            m = _LINE.search(line)
+            if m:
+                times[m.group(1)] = int(m.group(2))
+    return arch, times, failed
+
+
+def main():
+    ap = argparse.ArgumentParser()
+    ap.add_argument("first", help="Boot log of the first build")
+    ap.add_argument("second", help="Boot log of the second build")
+    args = ap.parse_args()
+
+    arch_a, a, failed_a = read_log(args.first)
+    arch_b, b, failed_b = read_log(args.second)
+    for arch, failed in ((arch_a, failed_a), (arch_b, failed_b)):
+        if failed:
+            print(f"{arch}: check FAILED: {', '.join(failed)}")
+    names = list(a) + [n for n in b if n not in a]
+    if not names:
+        raise SystemExit("no bench lines found")
+
+    width = max(len(n) for n in names)
+    print(f"{'kernel':<{width}} {arch_a:>12} {arch_b:>12}  ratio")
+    for n in names:
+        ta, tb = a.get(n), b.get(n)
+        ratio = f"{tb / ta:5.2f}" if ta and tb is not None else "    -"
+        fa = f"{ta} us" if ta is not None else "-"
+        fb = f"{tb} us" if tb is not None else "-"
+        print(f"{n:<{width}} {fa:>12} {fb:>12}  {ratio}")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,178 @@
+"""Stand-in for the firmware's TCP transport, for testing without hardware.
+
+Listens like a Wi-Fi build of mindwrite_epd_stream, parses the stream protocol
+(MWF1/MWP1/MWR1/MWC1/MWZ1/MWD1/MWM1, see src/frame_protocol.h), checks length and CRC
+(and decodes MWZ1 bands, tracks which MWD1 reference slots hold a frame) and
+answers OK/ER exactly like the device. Point any host tool at it:
+
+    python loopback_device.py --size 792x272 &
+    python pc_stream_pygame.py --tcp 127.0.0.1 --fps 10
+
+--refresh-ms emulates the panel: the reader stops pulling bytes for that long
+after each frame, so the host sees the same TCP back-pressure as on hardware.
+With MW_CTL_TIMING enabled the ACKs report it as eta_ms/refresh_ms.
+"""
+import argparse
+import binascii
+import socket
+import struct
+import time
+
+from mw_bands import unpack_bands
+from mw_refs import CURRENT, NONE, parse_delta, parse_move
+from mw_link import DEFAULT_NET_PORT
+
+CONTROL_MAX = 64
+RECT_HEADER = 9
+BANDS_HEADER = 4
+DELTA_HEADER = 4
+MOVE_HEADER = 13
+CTL_TIMING = 0x02
+
+
+def recv_exact(conn: socket.socket, n: int) -> bytes:
+    buf = bytearray()
+    while len(buf) < n:
+        chunk = conn.recv(n - len(buf))
+        if not chunk:
+            raise ConnectionError("peer closed")
+        buf += chunk
+    return bytes(buf)
+
+
+def serve(conn: socket.socket, frame_bytes: int, row_bytes: int, refresh_s: float, verbose: bool,
+          stored=None):
+    """stored: per reference slot, whether it holds a frame (outlives connections
+    like the device's slots)"""
+    stored = [False] * 4 if stored is None else stored
+    ref_slots = len(stored)
+    frames = 0
+    nbytes = 0
+    t0 = time.monotonic()
+    window = b""
+    timing = False
+
+    while True:
+        # Hunt for a magic, byte by byte like the firmware parser
+        window = (window + recv_exact(conn, 1))[-4:]
+        if window not in (b"MWF1", b"MWP1", b"MWR1", b"MWC1", b"MWZ1", b"MWD1", b"MWM1"):
+            continue
+        magic, window = window, b""
+
+        panel = None if magic == b"MWF1" else recv_exact(conn, 1)[0]
+        (ln,) = struct.unpack("<I", recv_exact(conn, 4))
+
+        if magic == b"MWC1":
+            ok_len = 1 <= ln <= CONTROL_MAX
+        elif magic == b"MWR1":
+            ok_len = RECT_HEADER < ln <= frame_bytes + RECT_HEADER
+        elif magic == b"MWZ1":
+            ok_len = BANDS_HEADER < ln <= frame_bytes + RECT_HEADER
+        elif magic == b"MWD1":
+            ok_len = DELTA_HEADER <= ln <= frame_bytes + RECT_HEADER
+        elif magic == b"MWM1":
+            ok_len = MOVE_HEADER <= ln <= frame_bytes + RECT_HEADER
+        else:
+            ok_len = ln == frame_bytes
+        if not ok_len:
+            conn.sendall(b"ER\x01")
+            continue
+
+        payload = recv_exact(conn, ln)
+        (crc,) = struct.unpack("<I", recv_exact(conn, 4))
+        if binascii.crc32(payload) & 0xFFFFFFFF != crc:
+            conn.sendall(b"ER\x02")
+            continue
+
+        if magic == b"MWZ1":
+            try:
+                unpack_bands(payload, row_bytes, frame_bytes // row_bytes)
+            except ValueError as e:
+                if verbose:
+                    print(f"MWZ1 rejected: {e}")
+                conn.sendall(b"ER\x04")
+                continue
+
+        if magic == b"MWD1":
+            try:
+                ref, store, _, rects = parse_delta(payload)
+                if store != NONE and store >= ref_slots or ref != CURRENT and ref >= ref_slots:
+                    raise ValueError("slot out of range")
+            except ValueError as e:
+                if verbose:
+                    print(f"MWD1 rejected: {e}")
+                conn.sendall(b"ER\x03")
+                continue
+            if ref != CURRENT and not stored[ref]:
+                conn.sendall(b"ER\x05")
+                continue
+            if store != NONE:
+                stored[store] = True
+            if verbose:
+                print(f"MWD1 ref={ref} store={store} rects={len(rects)}")
+
+        if magic == b"MWM1":
+            try:
+                _, src, (dx, dy), rects = parse_move(payload)
+            except ValueError as e:
+                if verbose:
+                    print(f"MWM1 rejected: {e}")
+                conn.sendall(b"ER\x03")
+                continue
+            if verbose:
+                print(f"MWM1 {src} by ({dx}, {dy}) rects={len(rects)}")
+
+        if magic == b"MWC1" and payload[0] == CTL_TIMING:
+            if ln != 2:
+                conn.sendall(b"ER\x03")
+                continue
+            timing = payload[1] != 0
+
+        refresh_ms = min(int(refresh_s * 1000), 0xFFFF)
+        if timing and magic != b"MWC1":
+            conn.sendall(b"OK" + struct.pack("<BHH", panel or 0, refresh_ms, refresh_ms))
+        else:
+            conn.sendall(b"OK" + (bytes([panel]) if panel is not None else b""))
+        frames += 1
+        nbytes += ln + 13
+        if verbose:
+            print(f"{magic.decode()} panel={panel} len={ln}")
+
+        dt = time.monotonic() - t0
+        if dt >= 2.0:
+            print(f"{frames / dt:.1f} msg/s  {nbytes / dt / 1024:.0f} KiB/s")
+            frames, nbytes, t0 = 0, 0, time.monotonic()
+
+        if refresh_s > 0 and magic != b"MWC1":
+            time.sleep(refresh_s)
+
+
+def main():
+    ap = argparse.ArgumentParser()
+    ap.add_argument("--bind", default="127.0.0.1")
+    ap.add_argument("--port", type=int, default=DEFAULT_NET_PORT)
+    ap.add_argument("--size", default="792x272", help="Frame size WxH (as the firmware build)")
+    ap.add_argument("--refresh-ms", type=float, default=0.0, help="Emulated panel refresh per frame")
+    ap.add_argument("--refs", type=int, default=4, help="Reference slots (as MINDWRITE_REF_SLOTS)")
+    ap.add_argument("-v", "--verbose", action="store_true")
+    args = ap.parse_args()
+
+    w, h = (int(v) for v in args.size.lower().split("x"))
+    row_bytes = (w + 7) // 8
+    frame_bytes = row_bytes * h
+
+    stored = [False] * args.refs
+    with socket.create_server((args.bind, args.port)) as srv:
+        print(f"loopback device on {args.bind}:{args.port}, {w}x{h}")
+        while True:
+            conn, addr = srv.accept()
+            print(f"client {addr[0]}:{addr[1]}")
+            with conn:
+                try:
+                    serve(conn, frame_bytes, row_bytes, args.refresh_ms / 1000.0, args.verbose, stored)
+                except ConnectionError:
+                    print("client gone")
+
+
+if __name__ == "__main__":
+    main()
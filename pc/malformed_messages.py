@@ -0,0 +1,190 @@
+"""Malformed-message checks for the firmware's parsers (see src/frame_protocol.h).
+
+Sends each broken message, expects the device's OK/ER reply, then sends a small
+valid control message to show the parser is back in step. Runs against hardware
+or the loopback stand-in:
+
+    python loopback_device.py --size 792x272 &
+    python malformed_messages.py --tcp 127.0.0.1 --size 792x272
+
+Covers the length and CRC checks, MWZ1 band streams (a match reaching before the
+band start, literals past the band end, truncated sequences, band count, size and
+CRC mismatches), MWD1/MWM1 rect lists, and MWM1 moves far outside the frame
+(clipped on the device, so those are answered OK). Exits 1 if any case fails.
+"""
+import argparse
+import binascii
+import struct
+import sys
+import time
+
+from mw_bands import _sequence, lz4_block
+from mw_link import open_link
+
+ER_LENGTH, ER_CRC, ER_MESSAGE, ER_BANDS = 1, 2, 3, 4
+RECT_HEADER = 9  # MWR1 payload header; also the slack MW*1 lengths get over a frame
+BAND_ROWS = 16
+
+
+def message(magic: bytes, payload: bytes, panel=0, crc=None) -> bytes:
+    if crc is None:
+        crc = binascii.crc32(payload) & 0xFFFFFFFF
+    return magic + bytes([panel]) + struct.pack("<I", len(payload)) + payload + struct.pack("<I", crc)
+
+
+def header_only(magic: bytes, ln: int, panel=0) -> bytes:
+    """Magic, panel and length; the device answers before any payload."""
+    return magic + bytes([panel]) + struct.pack("<I", ln)
+
+
+# Resync probe: MW_CTL_TIMING off, for every panel (no panel work, answered OK 0xFF)
+PROBE = message(b"MWC1", bytes([0x02, 0]), panel=0xFF)
+
+
+def reply(link, timeout_s=2.0):
+    """(b'OK' or b'ER', byte), or None on timeout; other text is skipped."""
+    deadline = time.monotonic() + timeout_s
+    buf = bytearray()
+    while time.monotonic() < deadline:
+        buf += link.read(64)
+        for tag in (b"OK", b"ER"):
+            i = buf.find(tag)
+            if 0 <= i < len(buf) - 2:
+                return tag, buf[i + 2]
+    return None
+
+
+def bands(blocks, crcs, band_rows=BAND_ROWS, count=None, tail=b"") -> bytes:
+    """MWZ1 payload from raw LZ4 blocks (count/tail to break the table)."""
+    out = bytearray(struct.pack("<HH", band_rows, len(blocks) if count is None else count))
+    for block, crc in zip(blocks, crcs):
+        out += struct.pack("<II", len(block), crc)
+    for block in blocks:
+        out += block
+    return bytes(out) + tail
+
+
+def literals(data: bytes) -> bytes:
+    out = bytearray()
+    _sequence(out, data)
+    return bytes(out)
+
+
+def rect(x, y, w, h, fill=0xFF, pixels=None) -> bytes:
+    n = (w + 7) // 8 * h
+    return struct.pack("<HHHH", x, y, w, h) + (bytes([fill]) * n if pixels is None else pixels)
+
+
+def cases(w: int, h: int):
+    row_bytes = (w + 7) // 8
+    frame_bytes = row_bytes * h
+
+    # A white frame in bands: every band valid and tiny, so one can be broken at a time
+    rows = [min(BAND_ROWS, h - r) for r in range(0, h, BAND_ROWS)]
+    plain = [b"\xff" * (n * row_bytes) for n in rows]
+    good = [lz4_block(b) for b in plain]
+    crcs = [binascii.crc32(b) & 0xFFFFFFFF for b in plain]
+
+    def with_band(i, block, crc=None):
+        blocks, cs = list(good), list(crcs)
+        blocks[i] = block
+        if crc is not None:
+            cs[i] = crc
+        return bands(blocks, cs)
+
+    band1 = len(plain[1])
+    yield "MWZ1 valid", message(b"MWZ1", bands(good, crcs)), (b"OK", 0)
+    # 8 literals, then a match 20 back: inside the frame, but before band 1's start
+    before_start = bytes([0x80]) + b"\xff" * 8 + struct.pack("<H", 20) + literals(b"\xff" * (band1 - 12))
+    yield "MWZ1 match before band start", message(b"MWZ1", with_band(1, before_start)), (b"ER", ER_BANDS)
+    yield "MWZ1 literals past band end", message(b"MWZ1", with_band(1, literals(b"\xff" * (band1 + 16)))), (
+        b"ER",
+        ER_BANDS,
+    )
+    yield "MWZ1 band one byte short", message(b"MWZ1", with_band(1, literals(b"\xff" * (band1 - 1)))), (
+        b"ER",
+        ER_BANDS,
+    )
+    yield "MWZ1 truncated match offset", message(b"MWZ1", with_band(1, bytes([0x10, 0xFF, 0x01]))), (b"ER", ER_BANDS)
+    yield "MWZ1 truncated length run", message(b"MWZ1", with_band(1, bytes([0xF0, 0xFF, 0xFF]))), (b"ER", ER_BANDS)
+    yield "MWZ1 match distance 0", message(b"MWZ1", with_band(1, bytes([0x10, 0xFF, 0, 0]) + literals(b"\xff" * 8))), (
+        b"ER",
+        ER_BANDS,
+    )
+    yield "MWZ1 bad band CRC", message(b"MWZ1", with_band(0, good[0], crcs[0] ^ 1)), (b"ER", ER_BANDS)
+    yield "MWZ1 band count + 1", message(b"MWZ1", bands(good, crcs, count=len(good) + 1)), (b"ER", ER_BANDS)
+    yield "MWZ1 band count 0", message(b"MWZ1", bands([], [], count=0, tail=b"\0")), (b"ER", ER_BANDS)
+    yield "MWZ1 band rows 0", message(b"MWZ1", bands(good, crcs, band_rows=0)), (b"ER", ER_BANDS)
+    yield "MWZ1 trailing byte", message(b"MWZ1", bands(good, crcs, tail=b"\0")), (b"ER", ER_BANDS)
+    yield "MWZ1 table past payload", message(b"MWZ1", struct.pack("<HHB", BAND_ROWS, len(good), 0)), (b"ER", ER_BANDS)
+    yield "MWZ1 header only", header_only(b"MWZ1", 4), (b"ER", ER_LENGTH)
+    yield "MWZ1 overlong", header_only(b"MWZ1", frame_bytes + RECT_HEADER + 1), (b"ER", ER_LENGTH)
+
+    yield "MWR1 overlong", header_only(b"MWR1", frame_bytes + RECT_HEADER + 1), (b"ER", ER_LENGTH)
+    yield "MWR1 bad CRC", message(b"MWR1", bytes([0]) + rect(0, 0, 8, 1), crc=0), (b"ER", ER_CRC)
+
+    delta = struct.pack("<BBBB", 0xFF, 0xFF, 0, 1) + rect(8, 8, 16, 4)
+    yield "MWD1 valid", message(b"MWD1", delta), (b"OK", 0)
+    yield "MWD1 count past payload", message(b"MWD1", delta[:3] + bytes([2]) + delta[4:]), (b"ER", ER_MESSAGE)
+    yield "MWD1 trailing byte", message(b"MWD1", delta + b"\0"), (b"ER", ER_MESSAGE)
+    yield "MWD1 short pixels", message(b"MWD1", delta[:-1]), (b"ER", ER_MESSAGE)
+    yield "MWD1 zero width", message(b"MWD1", struct.pack("<BBBB", 0xFF, 0xFF, 0, 1) + rect(8, 8, 0, 4)), (
+        b"ER",
+        ER_MESSAGE,
+    )
+    yield "MWD1 bad lane", message(b"MWD1", struct.pack("<BBBB", 0xFF, 0xFF, 2, 0)), (b"ER", ER_MESSAGE)
+    yield "MWD1 store slot 200", message(b"MWD1", struct.pack("<BBBB", 0xFF, 200, 0, 0)), (b"ER", ER_MESSAGE)
+    yield "MWD1 ref slot 200", message(b"MWD1", struct.pack("<BBBB", 200, 0xFF, 0, 0)), (b"ER", ER_MESSAGE)
+    yield "MWD1 header short", header_only(b"MWD1", 3), (b"ER", ER_LENGTH)
+
+    def move(x, y, mw, mh, dx, dy, lane=0, tail=b""):
+        return message(b"MWM1", struct.pack("<BHHHHhh", lane, x, y, mw, mh, dx, dy) + tail)
+
+    yield "MWM1 valid, odd offset", move(10, 10, 100, 20, 5, 3, tail=rect(10, 10, 5, 20)), (b"OK", 0)
+    yield "MWM1 header short", header_only(b"MWM1", 12), (b"ER", ER_LENGTH)
+    yield "MWM1 bad lane", move(0, 0, 8, 8, 1, 0, lane=7), (b"ER", ER_MESSAGE)
+    yield "MWM1 truncated rect", move(0, 0, 8, 8, 1, 0, tail=rect(0, 0, 8, 8)[:-4]), (b"ER", ER_MESSAGE)
+    yield "MWM1 partial rect header", move(0, 0, 8, 8, 1, 0, tail=b"\0" * 7), (b"ER", ER_MESSAGE)
+    # Offsets and rects outside the frame are clipped away, not rejected
+    yield "MWM1 dx +32767", move(0, 0, w, h, 32767, 0), (b"OK", 0)
+    yield "MWM1 dx, dy -32768", move(0, 0, w, h, -32768, -32768), (b"OK", 0)
+    yield "MWM1 source past the frame", move(65535, 65535, 65535, 65535, -1, -1), (b"OK", 0)
+    yield "MWM1 huge source, last pixel", move(w - 1, h - 1, 65535, 65535, 1 - w, 1 - h), (b"OK", 0)
+    yield "MWM1 whole frame by -7", move(0, 0, w, h, -7, 0), (b"OK", 0)
+    yield "MWM1 empty source", move(5, 5, 0, 0, 3, 3), (b"OK", 0)
+    yield "MWM1 rect off the frame", move(0, 0, 8, 8, 1, 1, tail=rect(65528, 65528, 8, 2)), (b"OK", 0)
+
+
+def main():
+    ap = argparse.ArgumentParser()
+    link = ap.add_mutually_exclusive_group(required=True)
+    link.add_argument("--port", help="USB serial port")
+    link.add_argument("--tcp", help="Wi-Fi build (or loopback_device.py): host[:port]")
+    ap.add_argument("--baud", type=int, default=115200)
+    ap.add_argument("--size", default="792x272", help="Frame size WxH (as the firmware build)")
+    args = ap.parse_args()
+    w, h = (int(v) for v in args.size.lower().split("x"))
+
+    failed = 0
+    with open_link(args.port, args.tcp, args.baud) as ser:
+        time.sleep(0.5)
+        ser.reset_input_buffer()
+        for name, pkt, want in cases(w, h):
+            ser.write(pkt)
+            ser.flush()
+            got = reply(ser)
+            ser.write(PROBE)
+            ser.flush()
+            synced = reply(ser) == (b"OK", 0xFF)
+
+            ok = got == want and synced
+            failed += not ok
+            result = "ok" if ok else f"FAIL (got {got}, want {want}{'' if synced else ', lost sync'})"
+            print(f"{name:<32} {result}")
+
+    print(f"{failed} failed")
+    sys.exit(1 if failed else 0)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,148 @@
+"""Banded compressed frames (MWZ1 payloads, see src/frame_protocol.h).
+
+The frame is cut into row bands and each band is compressed on its own as one
+LZ4 block, so the firmware can decode bands in parallel on both cores:
+
+    band_rows:u16 band_count:u16 {len:u32 crc32:u32}[band_count] blocks...
+
+crc32 is over the band's decoded bytes. Plain Python, no lz4 package needed.
+"""
+import binascii
+import struct
+
+DEFAULT_BAND_ROWS = 16
+MAX_BANDS = 64
+
+_MIN_MATCH = 4
+_LAST_LITERALS = 5  # LZ4 block rules: a block ends in >= 5 literals ...
+_MATCH_LIMIT = 12  # ... and its last match starts >= 12 bytes before the end
+
+
+def _length(out: bytearray, v: int):
+    while v >= 255:
+        out.append(255)
+        v -= 255
+    out.append(v)
+
+
+def _sequence(out: bytearray, literals: bytes, dist: int = 0, mlen: int = 0):
+    lit = len(literals)
+    ml = mlen - _MIN_MATCH
+    out.append((min(lit, 15) << 4) | (min(ml, 15) if dist else 0))
+    if lit >= 15:
+        _length(out, lit - 15)
+    out += literals
+    if dist:
+        out += struct.pack("<H", dist)
+        if ml >= 15:
+            _length(out, ml - 15)
+
+
+def lz4_block(data: bytes) -> bytes:
+    """Greedy LZ4 block compressor (hash of the next 4 bytes -> last position)."""
+    n = len(data)
+    out = bytearray()
+    last = {}
+    anchor = 0
+    i = 0
+    limit = n - _MATCH_LIMIT
+    while i < limit:
+        key = data[i : i + 4]
+        cand = last.get(key)
+        last[key] = i
+        if cand is None or i - cand > 0xFFFF:
+            i += 1
+            continue
+
+        m = _MIN_MATCH
+        end = n - _LAST_LITERALS
+        while i + m < end and data[cand + m] == data[i + m]:
+            m += 1
+        _sequence(out, data[anchor:i], i - cand, m)
+        i += m
+        anchor = i
+    _sequence(out, data[anchor:])
+    return bytes(out)
+
+
+def lz4_unblock(block: bytes, cap: int) -> bytes:
+    """Inverse of lz4_block; raises ValueError on malformed input."""
+    out = bytearray()
+    i = 0
+
+    def length(v):
+        nonlocal i
+        if v == 15:
+            while True:
+                if i >= len(block):
+                    raise ValueError("truncated length")
+                b = block[i]
+                i += 1
+                v += b
+                if b != 255:
+                    break
+        return v
+
+    while i < len(block):
+        token = block[i]
+        i += 1
+        lit = length(token >> 4)
+        if i + lit > len(block):
+            raise ValueError("truncated literals")
+        out += block[i : i + lit]
+        i += lit
+        if i == len(block):
+            break
+        if i + 2 > len(block):
+            raise ValueError("truncated match")
+        (dist,) = struct.unpack_from("<H", block, i)
+        i += 2
+        mlen = length(token & 15) + _MIN_MATCH
+        if dist == 0 or dist > len(out):
+            raise ValueError("bad match distance")
+        for _ in range(mlen):
+            out.append(out[-dist])
+        if len(out) > cap:
+            raise ValueError("block too long")
+    return bytes(out)
+
+
+def pack_bands(frame: bytes, row_bytes: int, band_rows: int = DEFAULT_BAND_ROWS) -> bytes:
+    """Row-major frame -> MWZ1 payload."""
+    rows = len(frame) // row_bytes
+    band_rows = max(band_rows, -(-rows // MAX_BANDS))
+    step = band_rows * row_bytes
+    bands = [frame[o : o + step] for o in range(0, len(frame), step)]
+    blocks = [lz4_block(b) for b in bands]
+
+    out = bytearray(struct.pack("<HH", band_rows, len(bands)))
+    for band, block in zip(bands, blocks):
+        out += struct.pack("<II", len(block), binascii.crc32(band) & 0xFFFFFFFF)
+    for block in blocks:
+        out += block
+    return bytes(out)
+
+
+def unpack_bands(payload: bytes, row_bytes: int, rows: int) -> bytes:
+    """MWZ1 payload -> row-major frame, with the firmware's checks (ValueError)."""
+    if len(payload) < 4:
+        raise ValueError("short payload")
+    band_rows, count = struct.unpack_from("<HH", payload, 0)
+    if band_rows == 0 or count > MAX_BANDS or count != -(-rows // band_rows):
+        raise ValueError("bad band table")
+    if len(payload) < 4 + 8 * count:
+        raise ValueError("band table past payload")
+
+    off = 4 + 8 * count
+    frame = bytearray()
+    for i in range(count):
+        ln, crc = struct.unpack_from("<II", payload, 4 + 8 * i)
+        want = min(band_rows, rows - i * band_rows) * row_bytes
+        band = lz4_unblock(payload[off : off + ln], want)
+        if len(band) != want or binascii.crc32(band) & 0xFFFFFFFF != crc:
+            raise ValueError(f"band {i} does not decode")
+        frame += band
+        off += ln
+    if off != len(payload):
+        raise ValueError("band sizes do not add up")
+    return bytes(frame)
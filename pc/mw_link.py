@@ -0,0 +1,58 @@
+"""Host side of the frame links: USB serial or TCP (Wi-Fi builds).
+
+Both objects offer the small pyserial subset the tools use: read(n), write(b),
+flush(), in_waiting, reset_input_buffer() and use as a context manager.
+"""
+import select
+import socket
+
+DEFAULT_NET_PORT = 5790
+
+
+class TcpLink:
+    def __init__(self, host: str, port: int = DEFAULT_NET_PORT, timeout: float = 0.05):
+        self.sock = socket.create_connection((host, port), timeout=5)
+        self.sock.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
+        self.sock.settimeout(timeout)
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *exc):
+        self.close()
+
+    def close(self):
+        self.sock.close()
+
+    def read(self, n: int) -> bytes:
+        try:
+            return self.sock.recv(n)
+        except socket.timeout:
+            return b""
+
+    def write(self, data: bytes):
+        self.sock.sendall(data)
+
+    def flush(self):
+        pass
+
+    @property
+    def in_waiting(self) -> int:
+        ready, _, _ = select.select([self.sock], [], [], 0)
+        return 4096 if ready else 0
+
+    def reset_input_buffer(self):
+        while self.in_waiting:
+            if not self.read(4096):
+                break
+
+
+def open_link(port=None, tcp=None, baud=115200, timeout=0.05):
+    """--port COMx|/dev/ttyACM0 for USB, --tcp host[:port] for Wi-Fi."""
+    if tcp:
+        host, _, p = tcp.partition(":")
+        return TcpLink(host, int(p) if p else DEFAULT_NET_PORT, timeout)
+
+    import serial
+
+    return serial.Serial(port, baud, timeout=timeout, write_timeout=5)
@@ -0,0 +1,177 @@
+"""Delta frames against cached reference frames (MWD1 payloads, see src/frame_protocol.h).
+
+The device keeps a few reference slots (MINDWRITE_REF_SLOTS); the host decides what
+goes in them and mirrors their contents here. Each new frame is sent as rects on
+top of whichever base is cheapest: the frame the panel already has, or one of the
+slots. A UI switching between a document, a menu and a dialog thus pays only for
+what changed on the screen it returns to.
+
+    ref:u8 store:u8 lane:u8 count:u8 {x:u16 y:u16 w:u16 h:u16 pixels}[count]
+
+Rects are byte aligned horizontally: one per run of changed rows, spanning the
+changed byte columns of that run.
+
+MWM1 moves a region (any pixel offset) and then draws rects in the same format:
+
+    lane:u8 x:u16 y:u16 w:u16 h:u16 dx:i16 dy:i16 {x y w h pixels}...
+"""
+import struct
+
+CURRENT = 0xFF  # ref: keep the pending frame
+NONE = 0xFF  # store: do not cache the result
+HEADER = 4
+RECT_HEADER = 8
+MOVE_HEADER = 13
+MAX_RECTS = 255
+_ROW_GAP = 2  # unchanged rows tolerated inside one rect (each rect costs 8 bytes)
+
+
+def diff_rects(a: bytes, b: bytes, row_bytes: int):
+    """Byte-aligned (x, y, w, h) rects covering every byte where a and b differ."""
+    rows = len(b) // row_bytes
+    rects = []
+    y = 0
+    while y < rows:
+        r = slice(y * row_bytes, (y + 1) * row_bytes)
+        if a[r] == b[r]:
+            y += 1
+            continue
+
+        y0, lo, hi, gap = y, row_bytes, 0, 0
+        while y < rows and gap <= _ROW_GAP:
+            ra, rb = a[y * row_bytes : (y + 1) * row_bytes], b[y * row_bytes : (y + 1) * row_bytes]
+            if ra == rb:
+                gap += 1
+            else:
+                gap = 0
+                lo = min(lo, next(i for i in range(row_bytes) if ra[i] != rb[i]))
+                hi = max(hi, next(i for i in reversed(range(row_bytes)) if ra[i] != rb[i]) + 1)
+            y += 1
+        rects.append((lo * 8, y0, (hi - lo) * 8, y - gap - y0))
+    return rects
+
+
+def pack_delta(frame: bytes, rects, row_bytes: int, ref=CURRENT, store=NONE, lane=0) -> bytes:
+    """MWD1 payload drawing the given rects of frame (x and w multiples of 8)."""
+    out = bytearray(struct.pack("<BBBB", ref, store, lane, len(rects)))
+    for x, y, w, h in rects:
+        out += struct.pack("<HHHH", x, y, w, h)
+        for row in range(y, y + h):
+            o = row * row_bytes + x // 8
+            out += frame[o : o + w // 8]
+    return bytes(out)
+
+
+def parse_rects(payload: bytes, off: int, count=None):
+    """Rect list from off: count rects, or as many as fill the payload (None)."""
+    rects = []
+    while (len(rects) < count) if count is not None else (off < len(payload)):
+        if len(payload) - off < RECT_HEADER:
+            raise ValueError("truncated rect header")
+        x, y, w, h = struct.unpack_from("<HHHH", payload, off)
+        n = (w + 7) // 8 * h
+        off += RECT_HEADER
+        if w == 0 or h == 0 or n > len(payload) - off:
+            raise ValueError("bad rect")
+        rects.append((x, y, w, h, payload[off : off + n]))
+        off += n
+    if off != len(payload):
+        raise ValueError("rect sizes do not add up")
+    return rects
+
+
+def parse_delta(payload: bytes):
+    """MWD1 payload -> (ref, store, lane, [(x, y, w, h, pixels)]), with the firmware's
+    structural checks (ValueError). Slot numbers are not range-checked here."""
+    if len(payload) < HEADER:
+        raise ValueError("short payload")
+    ref, store, lane, count = struct.unpack_from("<BBBB", payload, 0)
+    if lane > 1:
+        raise ValueError("bad lane")
+    return ref, store, lane, parse_rects(payload, HEADER, count)
+
+
+def parse_move(payload: bytes):
+    """MWM1 payload -> (lane, (x, y, w, h), (dx, dy), [(x, y, w, h, pixels)]), with the
+    firmware's checks (ValueError)."""
+    if len(payload) < MOVE_HEADER:
+        raise ValueError("short payload")
+    lane, x, y, w, h, dx, dy = struct.unpack_from("<BHHHHhh", payload, 0)
+    if lane > 1:
+        raise ValueError("bad lane")
+    return lane, (x, y, w, h), (dx, dy), parse_rects(payload, MOVE_HEADER)
+
+
+class RefCache:
+    """Host mirror of the device's reference slots, with a slot policy.
+
+    Each slot holds the latest version of one "screen". A frame that is close to
+    a slot (or to what the panel shows) updates that slot; one that is close to
+    none of them is a new screen and takes the least recently used slot.
+    """
+
+    def __init__(self, slots: int, row_bytes: int, new_screen_pct: int = 5):
+        self.row_bytes = row_bytes
+        self.frames = [None] * slots
+        self.used = [0] * slots
+        self.clock = 0
+        self.current = None  # what the device's pending frame holds
+        self.current_slot = None  # slot that tracks the current screen
+        self.new_screen_pct = new_screen_pct
+
+    def reset(self):
+        """The device lost its slots (reboot, ER 0x05)."""
+        self.frames = [None] * len(self.frames)
+        self.current = None
+        self.current_slot = None
+
+    def _lru(self):
+        free = [i for i, f in enumerate(self.frames) if f is None]
+        if free:
+            return free[0]
+        return min(range(len(self.frames)), key=lambda i: self.used[i])
+
+    def encode(self, frame: bytes, lane: int = 0):
+        """MWD1 payload for frame, or None when a full frame is cheaper (then call
+        stored_full() once it is sent). Updates the mirror as if the device accepted it."""
+        bases = []
+        if self.current is not None:
+            bases.append((CURRENT, self.current))
+        bases += [(i, f) for i, f in enumerate(self.frames) if f is not None]
+        if not bases:
+            return None
+
+        best = None
+        for ref, base in bases:
+            rects = diff_rects(base, frame, self.row_bytes)
+            if len(rects) > MAX_RECTS:
+                continue
+            cost = HEADER + sum(RECT_HEADER + w // 8 * h for _, _, w, h in rects)
+            if best is None or cost < best[0]:
+                best = (cost, ref, rects)
+        if best is None or best[0] >= len(frame):
+            return None
+        cost, ref, rects = best
+
+        if cost * 100 > len(frame) * self.new_screen_pct:
+            store = self._lru()  # far from everything cached: a new screen
+        elif ref != CURRENT:
+            store = ref
+        else:
+            store = self.current_slot if self.current_slot is not None else self._lru()
+
+        self._remember(store, frame)
+        return pack_delta(frame, rects, self.row_bytes, ref, store, lane)
+
+    def stored_full(self, frame: bytes, lane: int = 0) -> bytes:
+        """After a full frame: MWD1 payload that snapshots it into a slot."""
+        store = self._lru()
+        self._remember(store, frame)
+        return pack_delta(frame, [], self.row_bytes, CURRENT, store, lane)
+
+    def _remember(self, slot: int, frame: bytes):
+        self.clock += 1
+        self.frames[slot] = frame
+        self.used[slot] = self.clock
+        self.current = frame
+        self.current_slot = slot
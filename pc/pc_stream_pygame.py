@@ -2,14 +2,25 @@ import argparse
 import binascii
 import struct
 import time
-import serial
 import pygame
 
+from mw_bands import pack_bands
+from mw_link import open_link
+from mw_refs import RefCache
+
 W, H = 792, 272
 BYTES_PER_ROW = (W + 7) // 8
 FRAME_BYTES = BYTES_PER_ROW * H
 
 
+def set_panel_size(size: str):
+    """Match the firmware's MINDWRITE_PANEL, e.g. '792x272' or '400x300'."""
+    global W, H, BYTES_PER_ROW, FRAME_BYTES
+    W, H = (int(v) for v in size.lower().split("x"))
+    BYTES_PER_ROW = (W + 7) // 8
+    FRAME_BYTES = BYTES_PER_ROW * H
+
+
 def pack_1bpp(surface: pygame.Surface, invert=False) -> bytes:
     rgb = pygame.image.tostring(surface, "RGB")
     fb = bytearray([0xFF]) * FRAME_BYTES  # white
@@ -32,16 +43,115 @@ def pack_1bpp(surface: pygame.Surface, invert=False) -> bytes:
     return bytes(fb)
 
 
-def build_packet(payload: bytes) -> bytes:
-    magic = b"MWF1"
+def build_packet(payload: bytes, panel=None, compress=False) -> bytes:
+    """MWF1 for the default panel, MWP1 + panel index for multi-panel builds.
+    compress: MWZ1 (row bands, decoded on both cores) when that is smaller."""
+    magic = b"MWF1" if panel is None else b"MWP1" + bytes([panel])
+    if compress:
+        bands = pack_bands(payload, BYTES_PER_ROW)
+        if len(bands) < len(payload):
+            magic, payload = b"MWZ1" + bytes([panel or 0]), bands
     ln = struct.pack("<I", len(payload))
     crc = binascii.crc32(payload) & 0xFFFFFFFF
     return magic + ln + payload + struct.pack("<I", crc)
 
 
-def wait_for_ok(ser: serial.Serial, timeout_s: float) -> bool:
+def pack_rect(surface: pygame.Surface, rect: pygame.Rect, invert=False) -> bytes:
+    """x:u16 y:u16 w:u16 h:u16 + 1bpp rows of one rectangle (clipped to the surface)."""
+    rect = rect.clip(surface.get_rect())
+    stride = (rect.w + 7) // 8
+    bits = bytearray([0xFF]) * (stride * rect.h)
+    for y in range(rect.h):
+        for x in range(rect.w):
+            r, g, b, *_ = surface.get_at((rect.x + x, rect.y + y))
+            black = (30 * r + 59 * g + 11 * b) // 100 < 128
+            if black != invert:
+                bits[y * stride + x // 8] &= ~(0x80 >> (x % 8))
+    return struct.pack("<HHHH", rect.x, rect.y, rect.w, rect.h) + bytes(bits)
+
+
+def build_rect(surface: pygame.Surface, rect: pygame.Rect, lane: int, panel=0, invert=False) -> bytes:
+    """MWR1 update of one rectangle; lane 1 = interactive (preempts background work)."""
+    payload = bytes([lane]) + pack_rect(surface, rect, invert)
+    ln = struct.pack("<I", len(payload))
+    crc = binascii.crc32(payload) & 0xFFFFFFFF
+    return b"MWR1" + bytes([panel]) + ln + payload + struct.pack("<I", crc)
+
+
+def build_delta(payload: bytes, panel=0) -> bytes:
+    """MWD1 delta (mw_refs.RefCache) for a panel."""
+    ln = struct.pack("<I", len(payload))
+    crc = binascii.crc32(payload) & 0xFFFFFFFF
+    return b"MWD1" + bytes([panel]) + ln + payload + struct.pack("<I", crc)
+
+
+def build_move(surface: pygame.Surface, src: pygame.Rect, dx: int, dy: int, rects, lane: int, panel=0,
+               invert=False) -> bytes:
+    """MWM1: move src by (dx, dy) on the device, then draw rects from surface."""
+    payload = struct.pack("<BHHHHhh", lane, src.x, src.y, src.w, src.h, dx, dy)
+    for r in rects:
+        if r.clip(surface.get_rect()).w > 0:
+            payload += pack_rect(surface, r, invert)
+    ln = struct.pack("<I", len(payload))
+    crc = binascii.crc32(payload) & 0xFFFFFFFF
+    return b"MWM1" + bytes([panel]) + ln + payload + struct.pack("<I", crc)
+
+
+def build_control(payload: bytes, panel=0xFF) -> bytes:
+    """MWC1 control message; panel 0xFF addresses every panel."""
+    ln = struct.pack("<I", len(payload))
+    crc = binascii.crc32(payload) & 0xFFFFFFFF
+    return b"MWC1" + bytes([panel]) + ln + payload + struct.pack("<I", crc)
+
+
+def refresh_policy(deadline_ms: int, quiet_ms: int, big_area_pct: int, trace: bool) -> bytes:
+    """MW_CTL_REFRESH_POLICY payload (see frame_protocol.h)."""
+    return struct.pack("<BHHBB", 0x01, deadline_ms, quiet_ms, big_area_pct, 1 if trace else 0)
+
+
+def timing_control(enable: bool) -> bytes:
+    """MW_CTL_TIMING payload: ACKs carry eta_ms/refresh_ms, refresh-done events follow."""
+    return struct.pack("<BB", 0x02, 1 if enable else 0)
+
+
+def wait_for_eta(ser, timeout_s: float):
+    """
+    Wait for a timing ACK ('O','K',panel,eta_ms:u16,refresh_ms:u16).
+    Returns (eta_ms, refresh_ms), or None on timeout. Refresh-done events
+    ('R','D',...) that arrive in between are skipped.
+    """
+    deadline = time.monotonic() + timeout_s
+    buf = bytearray()
+
+    while time.monotonic() < deadline:
+        pygame.event.pump()
+
+        chunk = ser.read(64)
+        if chunk:
+            buf += chunk
+            i = buf.find(b"OK")
+            if i >= 0 and len(buf) >= i + 7:
+                return struct.unpack_from("<HH", buf, i + 3)
+            if len(buf) > 256:
+                buf = buf[-256:]
+
+        time.sleep(0.001)
+
+    return None
+
+
+def sleep_responsive(seconds: float):
+    """Sleep while keeping the pygame window alive."""
+    end = time.monotonic() + seconds
+    while time.monotonic() < end:
+        pygame.event.pump()
+        time.sleep(min(0.01, max(0.0, end - time.monotonic())))
+
+
+def wait_for_ok(ser, timeout_s: float) -> bool:
     """
     Read bytes until we see b'OK' (in-stream), while not blocking pygame.
+    False on timeout or an 'ER' reply.
     """
     deadline = time.monotonic() + timeout_s
     last = bytearray()
@@ -55,6 +165,8 @@ def wait_for_ok(ser: serial.Serial, timeout_s: float) -> bool:
             last += chunk
             if b"OK" in last:
                 return True
+            if b"ER" in last:
+                return False
             # keep buffer bounded
             if len(last) > 256:
                 last = last[-256:]
@@ -67,7 +179,9 @@ def wait_for_ok(ser: serial.Serial, timeout_s: float) -> bool:
 
 def main():
     ap = argparse.ArgumentParser()
-    ap.add_argument("--port", required=True)
+    link = ap.add_mutually_exclusive_group(required=True)
+    link.add_argument("--port", help="USB serial port")
+    link.add_argument("--tcp", help="Wi-Fi build (or loopback_device.py): host[:port]")
     ap.add_argument("--baud", type=int, default=115200)
     ap.add_argument(
         "--fps",
@@ -76,27 +190,103 @@ def main():
         help="Target send rate. Full refresh is slow; start low.",
     )
     ap.add_argument("--invert", action="store_true")
+    ap.add_argument(
+        "--panel",
+        type=int,
+        default=None,
+        help="Panel index on a multi-panel board (sends MWP1 frames)",
+    )
+    ap.add_argument(
+        "--size",
+        default="792x272",
+        help="Panel size WxH (must match the firmware build)",
+    )
     ap.add_argument(
         "--ack-timeout",
         type=float,
         default=30.0,
         help="Seconds to wait for OK after a frame",
     )
+    ap.add_argument(
+        "--deadline-ms",
+        type=int,
+        default=None,
+        help="Refresh coalescing deadline (0 = refresh as soon as idle)",
+    )
+    ap.add_argument("--quiet-ms", type=int, default=10)
+    ap.add_argument("--big-area", type=int, default=50, help="Damage %% that refreshes at once")
+    ap.add_argument("--trace", action="store_true", help="Firmware prints scheduler decisions")
+    ap.add_argument(
+        "--pace",
+        action="store_true",
+        help="Ignore --fps; send each frame just before the panel can take it (timing ACKs)",
+    )
+    ap.add_argument(
+        "--pace-lead-ms",
+        type=int,
+        default=150,
+        help="With --pace: send this long before the predicted completion",
+    )
+    ap.add_argument(
+        "--compress",
+        action="store_true",
+        help="Send full frames as LZ4-compressed row bands (MWZ1) when that is smaller",
+    )
+    ap.add_argument(
+        "--refs",
+        type=int,
+        default=0,
+        help="Send frames as deltas against N cached reference frames (MWD1; <= MINDWRITE_REF_SLOTS)",
+    )
+    ap.add_argument(
+        "--menu",
+        action="store_true",
+        help="Overlay a menu screen every other 5 frames (shows what --refs saves)",
+    )
+    ap.add_argument(
+        "--rects",
+        action="store_true",
+        help="Send only the moving box as interactive rect updates",
+    )
+    ap.add_argument(
+        "--copy",
+        action="store_true",
+        help="Move the box on the device (MWM1) and send only the strip it uncovers",
+    )
     args = ap.parse_args()
+    set_panel_size(args.size)
 
     pygame.init()
     screen = pygame.display.set_mode((W, H))
     clock = pygame.time.Clock()
 
     # IMPORTANT: small timeout so reads don't freeze pygame
-    with serial.Serial(args.port, args.baud, timeout=0.05, write_timeout=5) as ser:
+    with open_link(args.port, args.tcp, args.baud, timeout=0.05) as ser:
         time.sleep(0.5)
 
         # Clear any boot text so we don't accidentally match old data
         ser.reset_input_buffer()
 
-        x = 0
+        if args.deadline_ms is not None or args.trace:
+            deadline = 30 if args.deadline_ms is None else args.deadline_ms
+            pol = refresh_policy(deadline, args.quiet_ms, args.big_area, args.trace)
+            ser.write(build_control(pol, 0xFF if args.panel is None else args.panel))
+            ser.flush()
+            if not wait_for_ok(ser, 2.0):
+                print("Refresh policy not acknowledged.")
+
+        if args.pace:
+            ser.write(build_control(timing_control(True), 0xFF))
+            ser.flush()
+            if not wait_for_ok(ser, 2.0):
+                print("Timing not acknowledged; falling back to --fps.")
+                args.pace = False
+
+        x = prev_x = 0
         vx = 12
+        n = 0
+        refs = RefCache(args.refs, BYTES_PER_ROW) if args.refs > 0 else None
+        panel = args.panel or 0
 
         while True:
             for event in pygame.event.get():
@@ -105,30 +295,72 @@ def main():
 
             screen.fill((255, 255, 255))
             pygame.draw.rect(screen, (0, 0, 0), pygame.Rect(x, 40, 120, 80), 0)
+            if args.menu and (n // 5) % 2:
+                menu = pygame.Rect(W // 4, 0, W // 2, H)
+                pygame.draw.rect(screen, (255, 255, 255), menu, 0)
+                pygame.draw.rect(screen, (0, 0, 0), menu, 4)
+                for row in range(24, H - 16, 32):
+                    pygame.draw.line(screen, (0, 0, 0), (menu.x + 24, row), (menu.right - 24, row), 6)
+            n += 1
             pygame.display.flip()
 
-            payload = pack_1bpp(screen, invert=args.invert)
-            pkt = build_packet(payload)
+            if args.copy and n > 1:
+                # The device shifts the box; the strip it leaves behind is redrawn white
+                dx = x - prev_x
+                old = pygame.Rect(prev_x, 40, 120, 80)
+                rects = [pygame.Rect(prev_x if dx > 0 else x + 120, 40, abs(dx), 80)]
+                if not screen.get_rect().contains(old):
+                    rects.append(pygame.Rect(x, 40, 120, 80))  # part of it was off the glass
+                src = old.clip(screen.get_rect())
+                pkts = [build_move(screen, src, dx, 0, rects, 1, panel, invert=args.invert)]
+            elif args.rects:
+                # Old and new box positions in one rect
+                dirty = pygame.Rect(x - abs(vx), 40, 120 + 2 * abs(vx), 80)
+                pkts = [build_rect(screen, dirty, 1, panel, invert=args.invert)]
+            else:
+                payload = pack_1bpp(screen, invert=args.invert)
+                delta = refs.encode(payload) if refs else None
+                if delta is not None:
+                    pkts = [build_delta(delta, panel)]
+                else:
+                    pkts = [build_packet(payload, args.panel, args.compress)]
+                    if refs:
+                        pkts.append(build_delta(refs.stored_full(payload), panel))
 
             # Drain any stray text before sending (helps if anything prints)
             waiting = ser.in_waiting
             if waiting:
                 ser.read(waiting)
 
-            ser.write(pkt)
-            ser.flush()
+            for pkt in pkts:
+                ser.write(pkt)
+                ser.flush()
 
-            ok = wait_for_ok(ser, args.ack_timeout)
-            if not ok:
-                print("ACK timeout (no OK).")
-                # Resync: flush input so next frame starts clean
-                ser.reset_input_buffer()
+                if args.pace:
+                    timing = wait_for_eta(ser, args.ack_timeout)
+                    ok = timing is not None
+                else:
+                    ok = wait_for_ok(ser, args.ack_timeout)
+                if not ok:
+                    print("ACK timeout (no OK).")
+                    # Resync: flush input so next frame starts clean; a device that
+                    # rebooted (ER 0x05) has lost its reference frames too
+                    ser.reset_input_buffer()
+                    if refs:
+                        refs.reset()
+                    break
 
+            prev_x = x
             x += vx
             if x < 0 or x + 120 > W:
                 vx = -vx
 
-            clock.tick(args.fps)
+            if args.pace and ok:
+                # eta_ms = this frame on the glass; the next one is merged until then anyway
+                eta_ms, refresh_ms = timing
+                sleep_responsive(max(0, eta_ms - args.pace_lead_ms) / 1000.0)
+            else:
+                clock.tick(args.fps)
 
 
 if __name__ == "__main__":
@@ -0,0 +1,197 @@
+#include "band_decoder.h"
+
+#include <cstring>
+
+#include "pico/flash.h"
+#include "pico/multicore.h"
+#include "pico/stdlib.h"
+#include "hardware/sync.h"
+
+#include "crc32.h"
+#include "frame_protocol.h"
+#include "sram_placement.h"
+
+// One frame's worth of bands, shared by both cores. Core 0 validates the table and
+// fills this in before publishing job_seq; bands are claimed through next_band.
+struct BandJob
+{
+    const uint8_t *src[MW_BANDS_MAX];
+    uint32_t src_len[MW_BANDS_MAX];
+    uint32_t crc[MW_BANDS_MAX];
+    uint8_t *dst;
+    uint32_t band_bytes; // decoded size of a full band
+    uint32_t last_bytes; // decoded size of the last band
+    int count;
+
+    volatile int next_band;
+    volatile bool failed;
+};
+
+static BandJob job;
+static volatile uint32_t job_seq = 0;  // bumped by core 0 for each frame
+static volatile uint32_t job_done = 0; // job_seq of the last frame core 1 finished
+static bool core1_running = false;
+
+static uint32_t u32le(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+// Take bands until none are left (runs on both cores)
+static void MW_RAM_FUNC(run_bands)()
+{
+    while (true)
+    {
+        int i = __atomic_fetch_add(&job.next_band, 1, __ATOMIC_RELAXED);
+        if (i >= job.count)
+            return;
+
+        uint32_t want = (i == job.count - 1) ? job.last_bytes : job.band_bytes;
+        uint8_t *out = job.dst + (uint32_t)i * job.band_bytes;
+        int got = BandDecoder::decode_block(job.src[i], job.src_len[i], out, want);
+        if (got != (int)want || crc32_compute(out, want) != job.crc[i])
+            job.failed = true;
+    }
+}
+
+static void core1_main()
+{
+    flash_safe_execute_core_init(); // settings writes park this core while flash is busy
+
+    uint32_t seen = 0;
+    while (true)
+    {
+        while (__atomic_load_n(&job_seq, __ATOMIC_ACQUIRE) == seen)
+            __wfe();
+        seen = job_seq;
+
+        run_bands();
+        __atomic_store_n(&job_done, seen, __ATOMIC_RELEASE);
+        __sev();
+    }
+}
+
+void BandDecoder::start()
+{
+    if (core1_running)
+        return;
+    multicore_launch_core1(core1_main);
+    core1_running = true;
+}
+
+bool BandDecoder::decode(const uint8_t *payload, uint32_t len, uint8_t *dst, int row_bytes, int rows,
+                         int cores)
+{
+    if (len < MW_BANDS_HEADER)
+        return false;
+
+    int band_rows = payload[0] | (payload[1] << 8);
+    int count = payload[2] | (payload[3] << 8);
+    if (band_rows <= 0 || count <= 0 || count > MW_BANDS_MAX || count != (rows + band_rows - 1) / band_rows)
+        return false;
+
+    uint32_t table = MW_BANDS_HEADER + (uint32_t)count * MW_BANDS_ENTRY;
+    if (len < table)
+        return false;
+
+    // Band sizes must add up to the payload exactly
+    const uint8_t *p = payload + MW_BANDS_HEADER;
+    uint32_t off = table;
+    for (int i = 0; i < count; ++i, p += MW_BANDS_ENTRY)
+    {
+        uint32_t n = u32le(p);
+        if (n > len - off)
+            return false;
+        job.src[i] = payload + off;
+        job.src_len[i] = n;
+        job.crc[i] = u32le(p + 4);
+        off += n;
+    }
+    if (off != len)
+        return false;
+
+    job.dst = dst;
+    job.band_bytes = (uint32_t)band_rows * (uint32_t)row_bytes;
+    job.last_bytes = (uint32_t)(rows - (count - 1) * band_rows) * (uint32_t)row_bytes;
+    job.count = count;
+    job.next_band = 0;
+    job.failed = false;
+
+    bool both = core1_running && cores > 1 && count > 1;
+    uint32_t seq = job_seq + 1;
+    if (both)
+    {
+        __atomic_store_n(&job_seq, seq, __ATOMIC_RELEASE);
+        __sev();
+    }
+
+    run_bands();
+
+    if (both)
+    {
+        while (__atomic_load_n(&job_done, __ATOMIC_ACQUIRE) != seq)
+            __wfe();
+    }
+    return !job.failed;
+}
+
+int MW_RAM_CODE("band_decoder") BandDecoder::decode_block(const uint8_t *src, uint32_t n, uint8_t *dst, uint32_t cap)
+{
+    const uint8_t *ip = src;
+    const uint8_t *const iend = src + n;
+    uint8_t *op = dst;
+    uint8_t *const oend = dst + cap;
+
+    // Length fields: 15 in the token nibble continues in 255-saturated bytes
+    auto extend = [&](uint32_t &v) -> bool
+    {
+        if (v != 15)
+            return true;
+        uint8_t b;
+        do
+        {
+            if (ip >= iend)
+                return false;
+            b = *ip++;
+            v += b;
+        } while (b == 255);
+        return true;
+    };
+
+    while (ip < iend)
+    {
+        uint32_t token = *ip++;
+
+        uint32_t lit = token >> 4;
+        if (!extend(lit) || lit > (uint32_t)(iend - ip) || lit > (uint32_t)(oend - op))
+            return -1;
+        memcpy(op, ip, lit);
+        op += lit;
+        ip += lit;
+        if (ip == iend)
+            break; // the last sequence has literals only
+
+        if (iend - ip < 2)
+            return -1;
+        uint32_t dist = (uint32_t)ip[0] | ((uint32_t)ip[1] << 8);
+        ip += 2;
+        uint32_t mlen = token & 15;
+        if (dist == 0 || dist > (uint32_t)(op - dst) || !extend(mlen))
+            return -1;
+        mlen += 4;
+        if (mlen > (uint32_t)(oend - op))
+            return -1;
+
+        // Overlapping matches repeat a pattern; distance 1 (runs of white) is a fill
+        const uint8_t *m = op - dist;
+        if (dist == 1)
+            memset(op, *m, mlen);
+        else if (dist >= mlen)
+            memcpy(op, m, mlen);
+        else
+            for (uint32_t k = 0; k < mlen; ++k)
+                op[k] = m[k];
+        op += mlen;
+    }
+    return (int)(op - dst);
+}
@@ -0,0 +1,23 @@
+#pragma once
+#include <cstdint>
+
+// Decoder for banded compressed frames (MWZ1, see frame_protocol.h).
+//
+// Bands are independent LZ4 blocks, so both cores take bands from a shared counter
+// and decode each one straight into its rows of the destination frame; there is no
+// per-band staging buffer. Core 1 does nothing else: it sleeps in WFE between frames.
+struct BandDecoder
+{
+    // Launch the core 1 worker. Call once at boot; until then decode() runs on core 0 only.
+    static void start();
+
+    // Decode a banded payload into dst (rows x row_bytes, row-major). Blocking; uses
+    // up to cores cores (1 or 2). False on a malformed band table, a band that does
+    // not decode to exactly its rows, or a band CRC mismatch. dst is then partly
+    // written.
+    static bool decode(const uint8_t *payload, uint32_t len, uint8_t *dst, int row_bytes, int rows,
+                       int cores = 2);
+
+    // LZ4 block -> dst; bytes written, or -1 if the block is malformed or needs more than cap
+    static int decode_block(const uint8_t *src, uint32_t n, uint8_t *dst, uint32_t cap);
+};
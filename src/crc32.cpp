@@ -1,21 +1,37 @@
 #include "crc32.h"
 
-static inline uint32_t crc32_update(uint32_t crc, uint8_t data)
+#include "sram_placement.h"
+
+// One table lookup per byte instead of eight shift/xor steps
+struct Crc32Table
+{
+    uint32_t v[256];
+};
+
+static constexpr Crc32Table make_table()
 {
-    crc ^= data;
-    for (int i = 0; i < 8; i++)
+    Crc32Table t{};
+    for (uint32_t i = 0; i < 256; ++i)
     {
-        crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320UL : (crc >> 1);
+        uint32_t c = i;
+        for (int k = 0; k < 8; ++k)
+            c = (c & 1) ? (c >> 1) ^ 0xEDB88320u : (c >> 1);
+        t.v[i] = c;
     }
+    return t;
+}
+
+// 1 KB, read by both cores while upload DMA streams out of main SRAM
+static constexpr Crc32Table MW_SCRATCH_X("crc32") CRC32_TABLE = make_table();
+
+uint32_t MW_RAM_FUNC(crc32_update)(uint32_t crc, const uint8_t *data, size_t len)
+{
+    for (size_t i = 0; i < len; i++)
+        crc = CRC32_TABLE.v[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
     return crc;
 }
 
 uint32_t crc32_compute(const uint8_t *data, size_t len)
 {
-    uint32_t crc = 0xFFFFFFFFUL;
-    for (size_t i = 0; i < len; i++)
-    {
-        crc = crc32_update(crc, data[i]);
-    }
-    return crc ^ 0xFFFFFFFFUL;
+    return ~crc32_update(CRC32_INIT, data, len);
 }
@@ -2,4 +2,9 @@
 #include <cstdint>
 #include <cstddef>
 
+// CRC-32 (IEEE 802.3, same as zlib/binascii.crc32)
 uint32_t crc32_compute(const uint8_t *data, size_t len);
+
+// Incremental form: start from CRC32_INIT, feed runs, finish with ~crc
+static constexpr uint32_t CRC32_INIT = 0xFFFFFFFFu;
+uint32_t crc32_update(uint32_t crc, const uint8_t *data, size_t len);
@@ -0,0 +1,979 @@
+#include "ssd1683.h"
+
+#include <cstring>
+
+#include "hardware/clocks.h"
+#include "hardware/dma.h"
+#include "hardware/pio.h"
+
+#include "crc32.h"
+#include "sram_placement.h"
+
+#include "ssd1683_bits.h"
+#include "ssd1683_hwseq.pio.h"
+#include "ssd1683_seq.h"
+#include "ssd1683_transform.h"
+
+// Panels built into the firmware (one explicit instantiation each, below)
+#include "ssd1683_gdey0579t93.h"
+#include "ssd1683_gdey042t81.h"
+
+// Fingerprint of one plane column for the RAM shadow. Every step is a bijection in
+// the word it mixes in, so a change confined to one word always changes the hash.
+static uint32_t MW_RAM_FUNC(column_hash)(const uint8_t *p, int n)
+{
+    uint32_t h = 0x811C9DC5u;
+    int i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        uint32_t w;
+        memcpy(&w, p + i, 4);
+        h = (h ^ w) * 0x9E3779B1u;
+    }
+    for (; i < n; ++i)
+        h = (h ^ p[i]) * 0x9E3779B1u;
+    return h ^ (h >> 16);
+}
+
+// Fixed sequences
+static constexpr auto SEQ_INIT = ssd1683_seq::Seq<16>()
+                                     .cmd(0x12) // SWRESET
+                                     .wait_busy()
+                                     .cmd(0x3C, {0x80}) // Border waveform (common demo init bits)
+                                     .cmd(0x18, {0x80}) // Temp sensor
+                                     .end();
+
+static constexpr auto SEQ_TRIGGER_FULL = ssd1683_seq::Seq<8>()
+                                             .cmd(0x22, {0xF7}) // Display update control: full
+                                             .cmd(0x20)         // Master activation
+                                             .end();
+
+// Geometry-driven replacement for the vendor Set_ramMP/MA and Set_ramSP/SA sequences:
+// RAM window over plane byte columns [k0, k1] and glass rows [y0, y1] (inclusive).
+// Y is always the fast axis, so plane column k / glass row y sits at
+// plane[k * HEIGHT + plane_off(y)] on every panel. Rows are walked bottom-up, or
+// top-down for orientations that need a vertical flip (Panel::Y_INC).
+// The slave die is mounted mirrored: its RAM X counts down from the seam.
+template <typename Traits>
+static constexpr ssd1683_seq::Seq<24> window_seq(bool slave, int k0, int k1, int y0, int y1)
+{
+    using Panel = SSD1683Panel<Traits>;
+    const uint8_t base = slave ? 0x80 : 0x00;
+
+    int x_start = slave ? (Traits::SLAVE_COLS - 1 - k0) : k0;
+    int x_end = slave ? (Traits::SLAVE_COLS - 1 - k1) : k1;
+    int y_start = Panel::Y_INC ? y0 : y1;
+    int y_end = Panel::Y_INC ? y1 : y0;
+
+    // AM=1 (Y first), ID1 = Y increment, ID0 = X increment (master) / decrement (slave)
+    uint8_t mode = 0x04 | (Panel::Y_INC ? 0x02 : 0x00) | (slave ? 0x00 : 0x01);
+
+    const uint8_t ys0 = (uint8_t)(y_start & 0xFF), ys1 = (uint8_t)(y_start >> 8);
+    const uint8_t ye0 = (uint8_t)(y_end & 0xFF), ye1 = (uint8_t)(y_end >> 8);
+
+    return ssd1683_seq::Seq<24>()
+        .cmd(0x11 | base, {mode})                                 // Data entry mode
+        .cmd(0x44 | base, {(uint8_t)x_start, (uint8_t)x_end})     // X window (bytes)
+        .cmd(0x45 | base, {ys0, ys1, ye0, ye1})                   // Y window
+        .cmd(0x4E | base, {(uint8_t)x_start})                     // X cursor
+        .cmd(0x4F | base, {ys0, ys1})                             // Y cursor
+        .end();
+}
+
+// Whole-plane windows, used after init and by the blocking paths
+template <typename Traits>
+static constexpr auto SEQ_FULL_MASTER = window_seq<Traits>(false, 0, Traits::MASTER_COLS - 1, 0, Traits::HEIGHT - 1);
+template <typename Traits>
+static constexpr auto SEQ_FULL_SLAVE = window_seq<Traits>(true, 0, Traits::SLAVE_COLS - 1, 0, Traits::HEIGHT - 1);
+
+// RAM write opcodes per die, as packet payloads for the hardware sequence
+static constexpr uint8_t WRITE_RAM_OP[2] = {0x24, 0xA4};
+
+// The state machine spends two cycles per SPI bit, so SCK runs at the calibrated
+// rate. Each byte also costs three cycles of pull/set/jmp with SCK low (19 cycles
+// for 8 bits), so the sequencer's byte rate is 16/19 of the hardware SPI's, ~16%
+// lower. The divider is not raised to make that up: the bits themselves would
+// then clock above what probe_spi verified.
+static float hwseq_clkdiv(uint32_t hz)
+{
+    float div = (float)clock_get_hz(clk_sys) / (2.0f * (float)hz);
+    return div < 1.0f ? 1.0f : div;
+}
+
+template <typename Traits>
+SSD1683<Traits>::SSD1683(spi_inst_t *spi,
+                         uint pin_cs, uint pin_dc, uint pin_rst, uint pin_busy,
+                         uint pin_sck, uint pin_mosi)
+    : spi_(spi),
+      cs_(pin_cs), dc_(pin_dc), rst_(pin_rst), busy_(pin_busy),
+      sck_(pin_sck), mosi_(pin_mosi) {}
+
+template <typename Traits>
+void SSD1683<Traits>::cs_select_(bool en) { gpio_put(cs_, en ? 0 : 1); }
+template <typename Traits>
+void SSD1683<Traits>::dc_cmd_() { gpio_put(dc_, 0); }
+template <typename Traits>
+void SSD1683<Traits>::dc_data_() { gpio_put(dc_, 1); }
+
+template <typename Traits>
+void SSD1683<Traits>::write_u8_(uint8_t v) { spi_write_blocking(spi_, &v, 1); }
+template <typename Traits>
+void SSD1683<Traits>::write_bytes_(const uint8_t *data, size_t n) { spi_write_blocking(spi_, data, n); }
+
+template <typename Traits>
+void SSD1683<Traits>::dma_start_(const uint8_t *data, size_t n, bool increment)
+{
+    dma_channel_config c = dma_channel_get_default_config(dma_chan_);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_8);
+    channel_config_set_dreq(&c, spi_get_dreq(spi_, true));
+    channel_config_set_read_increment(&c, increment);
+    channel_config_set_write_increment(&c, false);
+    dma_channel_configure(dma_chan_, &c, &spi_get_hw(spi_)->dr, data, n, true);
+}
+
+template <typename Traits>
+void SSD1683<Traits>::dma_drain_()
+{
+    // TX-only: wait for the shifter, then drop whatever landed in RX (same as spi_write_blocking)
+    while (spi_is_busy(spi_))
+        tight_loop_contents();
+    while (spi_is_readable(spi_))
+        (void)spi_get_hw(spi_)->dr;
+    spi_get_hw(spi_)->icr = SPI_SSPICR_RORIC_BITS;
+}
+
+template <typename Traits>
+void SSD1683<Traits>::write_dma_(const uint8_t *data, size_t n, bool increment)
+{
+    dma_start_(data, n, increment);
+    dma_channel_wait_for_finish_blocking(dma_chan_);
+    dma_drain_();
+}
+
+template <typename Traits>
+void SSD1683<Traits>::begin_burst_(const uint8_t *data, size_t n)
+{
+    burst_src_ = data;
+    burst_left_ = (uint32_t)n;
+    burst_inc_ = true;
+    next_slice_();
+}
+
+template <typename Traits>
+void SSD1683<Traits>::begin_fill_(uint8_t v, size_t n)
+{
+    fill_byte_ = v;
+
+    burst_src_ = &fill_byte_;
+    burst_left_ = (uint32_t)n;
+    burst_inc_ = false;
+    next_slice_();
+}
+
+// The controller keeps its RAM write pointer across CS cycles, so a burst may be
+// split anywhere as long as no command is sent to this panel in between.
+template <typename Traits>
+void SSD1683<Traits>::next_slice_()
+{
+    uint32_t n = burst_left_;
+    if (slice_bytes_ > 0 && n > slice_bytes_)
+        n = slice_bytes_;
+
+    cs_select_(true);
+    dc_data_();
+    dma_start_(burst_src_, n, burst_inc_);
+    slice_open_ = true;
+
+    if (burst_inc_)
+        burst_src_ += n;
+    burst_left_ -= n;
+}
+
+template <typename Traits>
+bool SSD1683<Traits>::end_slice_()
+{
+    if (!slice_open_)
+        return true;
+    if (dma_channel_is_busy(dma_chan_))
+        return false;
+
+    // Slice is out of the FIFO; at most a few bytes are still shifting
+    dma_drain_();
+    cs_select_(false);
+    slice_open_ = false;
+    return true;
+}
+
+template <typename Traits>
+void SSD1683<Traits>::data_burst_(const uint8_t *data, size_t n)
+{
+    cs_select_(true);
+    dc_data_();
+    write_dma_(data, n, true);
+    cs_select_(false);
+}
+
+template <typename Traits>
+void SSD1683<Traits>::data_fill_(uint8_t v, size_t n)
+{
+    fill_byte_ = v;
+
+    cs_select_(true);
+    dc_data_();
+    write_dma_(&fill_byte_, n, false);
+    cs_select_(false);
+}
+
+template <typename Traits>
+void SSD1683<Traits>::cmd_(uint8_t c)
+{
+    cs_select_(true);
+    dc_cmd_();
+    write_u8_(c);
+    cs_select_(false);
+}
+
+// One CS frame per command: opcode with DC low, then its parameters in a single write
+template <typename Traits>
+bool SSD1683<Traits>::run_seq_(const uint8_t *seq, uint32_t timeout_ms)
+{
+    while (true)
+    {
+        uint8_t op = *seq++;
+        switch (op)
+        {
+        case ssd1683_seq::END:
+            return true;
+
+        case ssd1683_seq::WAIT_BUSY:
+            if (!wait_idle(timeout_ms))
+                return false;
+            break;
+
+        case ssd1683_seq::DELAY_MS:
+            sleep_ms(*seq++);
+            break;
+
+        default:
+            cs_select_(true);
+            dc_cmd_();
+            write_u8_(*seq++); // returns once the byte has left the shifter
+            if (op > 0)
+            {
+                dc_data_();
+                write_bytes_(seq, op);
+                seq += op;
+            }
+            cs_select_(false);
+            break;
+        }
+    }
+}
+
+// Read timing: the controller shifts data out on the falling edge and needs a
+// slower clock for reads than for writes; half a period of ~0.5 us is safe.
+static constexpr uint32_t READ_HALF_CYCLES = 80;
+
+template <typename Traits>
+void SSD1683<Traits>::read_begin_(uint8_t c)
+{
+    cs_select_(true);
+    dc_cmd_();
+    write_u8_(c);
+    dc_data_();
+
+    gpio_init(sck_);
+    gpio_set_dir(sck_, GPIO_OUT);
+    gpio_put(sck_, 0);
+    gpio_init(mosi_);
+    gpio_set_dir(mosi_, GPIO_IN);
+}
+
+template <typename Traits>
+uint8_t SSD1683<Traits>::read_u8_()
+{
+    uint8_t v = 0;
+    for (int i = 0; i < 8; ++i)
+    {
+        busy_wait_at_least_cycles(READ_HALF_CYCLES);
+        gpio_put(sck_, 1);
+        busy_wait_at_least_cycles(READ_HALF_CYCLES);
+        v = (uint8_t)((v << 1) | (gpio_get(mosi_) ? 1 : 0));
+        gpio_put(sck_, 0);
+    }
+    return v;
+}
+
+template <typename Traits>
+void SSD1683<Traits>::read_end_()
+{
+    cs_select_(false);
+    gpio_set_function(sck_, GPIO_FUNC_SPI);
+    gpio_set_function(mosi_, GPIO_FUNC_SPI);
+}
+
+template <typename Traits>
+void SSD1683<Traits>::reset_()
+{
+    gpio_put(rst_, 0);
+    sleep_ms(10);
+    gpio_put(rst_, 1);
+    sleep_ms(10);
+}
+
+template <typename Traits>
+bool SSD1683<Traits>::busy() const
+{
+    return gpio_get(busy_) == Traits::BUSY_ACTIVE_HIGH;
+}
+
+template <typename Traits>
+bool SSD1683<Traits>::wait_idle(uint32_t timeout_ms)
+{
+    absolute_time_t start = get_absolute_time();
+    while (true)
+    {
+        if (!busy())
+            return true;
+
+        if (absolute_time_diff_us(start, get_absolute_time()) > (int64_t)timeout_ms * 1000)
+        {
+            return false;
+        }
+        sleep_ms(5);
+    }
+}
+
+template <typename Traits>
+void SSD1683<Traits>::trigger_full_()
+{
+    run_seq_(SEQ_TRIGGER_FULL.b, 0);
+}
+
+template <typename Traits>
+void SSD1683<Traits>::update_full_()
+{
+    trigger_full_();
+    wait_idle(20000);
+}
+
+template <typename Traits>
+bool SSD1683<Traits>::init(uint32_t spi_hz)
+{
+    gpio_init(cs_);
+    gpio_set_dir(cs_, GPIO_OUT);
+    gpio_put(cs_, 1);
+    gpio_init(dc_);
+    gpio_set_dir(dc_, GPIO_OUT);
+    gpio_put(dc_, 0);
+    gpio_init(rst_);
+    gpio_set_dir(rst_, GPIO_OUT);
+    gpio_put(rst_, 1);
+    gpio_init(busy_);
+    gpio_set_dir(busy_, GPIO_IN);
+
+    spi_init(spi_, spi_hz);
+    spi_set_format(spi_, 8, SPI_CPOL_0, SPI_CPHA_0, SPI_MSB_FIRST);
+    gpio_set_function(sck_, GPIO_FUNC_SPI);
+    gpio_set_function(mosi_, GPIO_FUNC_SPI);
+
+    if (dma_chan_ < 0)
+        dma_chan_ = dma_claim_unused_channel(true);
+    spi_hz_ = spi_hz;
+
+    sleep_ms(20);
+    inited_ = true;
+    return setup_controller_(5000);
+}
+
+template <typename Traits>
+bool SSD1683<Traits>::setup_controller_(uint32_t timeout_ms)
+{
+    reset_();
+    return run_seq_(SEQ_INIT.b, timeout_ms);
+}
+
+template <typename Traits>
+bool SSD1683<Traits>::reset(uint32_t timeout_ms)
+{
+    if (!inited_)
+        return false;
+
+    // A stalled DMA must not hold the bus (or CS) any longer
+    if (hw_armed_)
+        hw_abort_();
+    else if (step_ != Step::IDLE)
+    {
+        dma_channel_abort(dma_chan_);
+        dma_drain_();
+        cs_select_(false);
+        slice_open_ = false;
+        burst_left_ = 0;
+        step_ = Step::IDLE;
+    }
+
+    // RAM contents are gone
+    shadow_valid_ = false;
+    old_stale_ = true;
+    return setup_controller_(timeout_ms);
+}
+
+template <typename Traits>
+void SSD1683<Traits>::set_ram_window_(Ctrl ctrl, int k0, int k1, int y0, int y1)
+{
+    run_seq_(window_seq<Traits>(ctrl == Ctrl::SLAVE, k0, k1, y0, y1).b, 0);
+}
+
+template <typename Traits>
+void SSD1683<Traits>::set_full_window_(Ctrl ctrl)
+{
+    run_seq_(ctrl == Ctrl::SLAVE ? SEQ_FULL_SLAVE<Traits>.b : SEQ_FULL_MASTER<Traits>.b, 0);
+}
+
+template <typename Traits>
+void SSD1683<Traits>::write_plane_(Ctrl ctrl, const uint8_t *plane, size_t n, uint8_t fill)
+{
+    const uint8_t base = (uint8_t)ctrl;
+    set_full_window_(ctrl);
+    wait_idle(5000);
+
+    cmd_(0x24 | base);
+    if (plane)
+        data_burst_(plane, n);
+    else
+        data_fill_(fill, n);
+
+    cmd_(0x26 | base); // "old" buffer used by some update modes; keep cleared
+    data_fill_(0x00, n);
+}
+
+template <typename Traits>
+void SSD1683<Traits>::upload_(const uint8_t *master_plane, const uint8_t *slave_plane, uint8_t fill)
+{
+    write_plane_(Ctrl::MASTER, master_plane, Panel::MASTER_PLANE_BYTES, fill);
+    if constexpr (Panel::DUAL)
+        write_plane_(Ctrl::SLAVE, slave_plane, Panel::SLAVE_PLANE_BYTES, fill);
+}
+
+template <typename Traits>
+void SSD1683<Traits>::clear_to_white()
+{
+    if (!inited_)
+        return;
+
+    upload_(nullptr, nullptr, Panel::xform(0xFF));
+    shadow_valid_ = false;
+    old_stale_ = false;
+    update_full_();
+}
+
+template <typename Traits>
+void SSD1683<Traits>::show_full_fullscreen(const uint8_t *frame)
+{
+    if (!inited_)
+        return;
+
+    // Convert once into controller order (tiled word kernel), then burst each plane
+    alignas(4) static uint8_t master[Panel::MASTER_PLANE_BYTES];
+    alignas(4) static uint8_t slave[Panel::DUAL ? Panel::SLAVE_PLANE_BYTES : 4];
+    ssd1683_transform_rowmajor<Traits>(frame, master, slave);
+
+    upload_sync_(master, slave);
+}
+
+template <typename Traits>
+void SSD1683<Traits>::show_full_native(const uint8_t *master_plane, const uint8_t *slave_plane)
+{
+    if (!inited_)
+        return;
+
+    upload_sync_(master_plane, slave_plane);
+}
+
+// Blocking wrapper around the async upload, so both paths share the RAM shadow
+template <typename Traits>
+void SSD1683<Traits>::upload_sync_(const uint8_t *master_plane, const uint8_t *slave_plane)
+{
+    wait_idle(5000);
+    start_full_native(master_plane, slave_plane);
+    while (upload_poll())
+        tight_loop_contents();
+    wait_idle(20000);
+}
+
+// Hash every plane column and mark the ones that differ from the shadow. Columns
+// still dirty from an aborted upload stay dirty.
+template <typename Traits>
+void SSD1683<Traits>::mark_dirty_(const uint8_t *master_plane, const uint8_t *slave_plane)
+{
+    for (int g = 0; g < COLS; ++g)
+    {
+        const uint8_t *col = (g < Traits::MASTER_COLS)
+                                 ? master_plane + g * Panel::HEIGHT
+                                 : slave_plane + (g - Traits::MASTER_COLS) * Panel::HEIGHT;
+        uint32_t h = column_hash(col, Panel::HEIGHT);
+        if (!shadow_valid_ || h != col_hash_[g])
+            dirty_[g >> 5] |= 1u << (g & 31);
+        col_hash_[g] = h;
+    }
+    shadow_valid_ = true;
+}
+
+// Window and burst for the next run of dirty columns on one controller; false when
+// none is left
+template <typename Traits>
+bool SSD1683<Traits>::next_run_()
+{
+    int g = ssd1683_bits::next_set(dirty_, run_next_, COLS);
+    if (g >= COLS)
+        return false;
+
+    const bool slave = (g >= Traits::MASTER_COLS);
+    const int end = slave ? COLS : Traits::MASTER_COLS;
+    const int g1 = ssd1683_bits::next_clear(dirty_, g, end) - 1;
+
+    run_g0_ = g;
+    run_g1_ = g1;
+    run_next_ = g1 + 1;
+
+    const int base = slave ? Traits::MASTER_COLS : 0;
+    const int k0 = g - base, k1 = g1 - base;
+    const size_t n = (size_t)(k1 - k0 + 1) * Panel::HEIGHT;
+    const Ctrl ctrl = slave ? Ctrl::SLAVE : Ctrl::MASTER;
+
+    set_ram_window_(ctrl, k0, k1, 0, Panel::HEIGHT - 1);
+    cmd_(0x24 | (uint8_t)ctrl);
+    begin_burst_((slave ? async_slave_ : async_master_) + k0 * Panel::HEIGHT, n);
+    upload_bytes_ += (uint32_t)n;
+    return true;
+}
+
+template <typename Traits>
+void SSD1683<Traits>::start_full_native(const uint8_t *master_plane, const uint8_t *slave_plane)
+{
+    if (!inited_ || step_ != Step::IDLE)
+        return;
+
+    async_master_ = master_plane;
+    async_slave_ = slave_plane;
+    mark_dirty_(master_plane, slave_plane);
+
+    run_next_ = 0;
+    upload_bytes_ = 0;
+    step_ = Step::NEW;
+    if (queues_while_busy())
+        hw_start_();
+    else
+        advance_();
+}
+
+template <typename Traits>
+bool SSD1683<Traits>::advance_()
+{
+    switch (step_)
+    {
+    case Step::NEW:
+        if (next_run_())
+            return true;
+        if (!old_stale_)
+            break;
+
+        // "old" buffer used by some update modes; keep cleared. The refresh leaves it
+        // alone, so this only happens after init/reset.
+        set_full_window_(Ctrl::MASTER);
+        cmd_(0x26);
+        begin_fill_(0x00, Panel::MASTER_PLANE_BYTES);
+        upload_bytes_ += Panel::MASTER_PLANE_BYTES;
+        step_ = Step::MASTER_OLD;
+        return true;
+
+    case Step::MASTER_OLD:
+        if constexpr (Panel::DUAL)
+        {
+            set_full_window_(Ctrl::SLAVE);
+            cmd_(0xA6);
+            begin_fill_(0x00, Panel::SLAVE_PLANE_BYTES);
+            upload_bytes_ += Panel::SLAVE_PLANE_BYTES;
+            step_ = Step::SLAVE_OLD;
+            return true;
+        }
+        old_stale_ = false;
+        break;
+
+    case Step::SLAVE_OLD:
+        old_stale_ = false;
+        break;
+
+    default:
+        break;
+    }
+
+    trigger_full_();
+    step_ = Step::IDLE;
+    return false;
+}
+
+template <typename Traits>
+bool SSD1683<Traits>::upload_poll()
+{
+    if (step_ == Step::IDLE)
+        return false;
+    if (hw_armed_)
+        return hw_poll_();
+    if (!end_slice_())
+        return true;
+
+    if (burst_left_ > 0)
+    {
+        next_slice_();
+        return true;
+    }
+
+    // A finished run is in RAM; an aborted one stays dirty for the next upload
+    if (step_ == Step::NEW)
+    {
+        for (int g = run_g0_; g <= run_g1_; ++g)
+            dirty_[g >> 5] &= ~(1u << (g & 31));
+    }
+    return advance_();
+}
+
+// Read plane columns [k0, k1] of one die and compare each with HEIGHT bytes of
+// expect (column k at expect + (k - k0) * HEIGHT). Mismatching columns are marked
+// dirty in the shadow; returns how many there were.
+template <typename Traits>
+int SSD1683<Traits>::read_check_(Ctrl ctrl, int k0, int k1, const uint8_t *expect)
+{
+    const int base = (ctrl == Ctrl::SLAVE) ? Traits::MASTER_COLS : 0;
+
+    set_ram_window_(ctrl, k0, k1, 0, Panel::HEIGHT - 1);
+    const uint8_t option[] = {1, (uint8_t)(0x41 | (uint8_t)ctrl), 0x00, ssd1683_seq::END};
+    run_seq_(option, 0); // Read RAM option: the "new" (0x24) buffer
+
+    int bad = 0;
+    read_begin_(0x27 | (uint8_t)ctrl);
+    (void)read_u8_(); // dummy byte
+    for (int k = k0; k <= k1; ++k, expect += Panel::HEIGHT)
+    {
+        uint32_t crc = CRC32_INIT;
+        for (int y = 0; y < Panel::HEIGHT; ++y)
+        {
+            uint8_t b = read_u8_();
+            crc = crc32_update(crc, &b, 1);
+        }
+        if (crc != crc32_update(CRC32_INIT, expect, Panel::HEIGHT))
+        {
+            const int g = base + k;
+            dirty_[g >> 5] |= 1u << (g & 31);
+            ++bad;
+        }
+    }
+    read_end_();
+    return bad;
+}
+
+template <typename Traits>
+int SSD1683<Traits>::verify_ram(const uint8_t *master_plane, const uint8_t *slave_plane, int g0, int g1)
+{
+    if (!inited_ || step_ != Step::IDLE || busy())
+        return -1;
+    if (g0 < 0)
+        g0 = 0;
+    if (g1 > COLS)
+        g1 = COLS;
+
+    int bad = 0;
+    while (g0 < g1)
+    {
+        // One window and one read burst per die
+        const bool slave = (g0 >= Traits::MASTER_COLS);
+        const int base = slave ? Traits::MASTER_COLS : 0;
+        const int end = (slave || g1 <= Traits::MASTER_COLS) ? g1 : Traits::MASTER_COLS;
+        const uint8_t *plane = slave ? slave_plane : master_plane;
+
+        bad += read_check_(slave ? Ctrl::SLAVE : Ctrl::MASTER, g0 - base, end - 1 - base,
+                           plane + (g0 - base) * Panel::HEIGHT);
+        g0 = end;
+    }
+    return bad;
+}
+
+template <typename Traits>
+uint32_t SSD1683<Traits>::set_spi_hz(uint32_t hz)
+{
+    spi_hz_ = spi_set_baudrate(spi_, hz);
+    if (hw_)
+        pio_sm_set_clkdiv(hw_pio_, hw_sm_, hwseq_clkdiv(spi_hz_));
+    return spi_hz_;
+}
+
+// Write a test column at hz, read it back at the (fixed, slow) read clock. The
+// first bytes toggle every bit for the sharpest edges; the rest is pseudo-random
+// so stuck or swapped bits show up too. The probe column is left dirty.
+template <typename Traits>
+bool SSD1683<Traits>::probe_spi(uint32_t hz)
+{
+    if (!inited_ || step_ != Step::IDLE || busy())
+        return false;
+
+    static uint8_t pattern[Panel::HEIGHT];
+    uint32_t x = 0x2545F491u ^ hz;
+    for (int i = 0; i < Panel::HEIGHT; ++i)
+    {
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        pattern[i] = (i < 16) ? ((i & 1) ? 0xAA : 0x55) : (uint8_t)x;
+    }
+
+    set_spi_hz(hz);
+    set_ram_window_(Ctrl::MASTER, PROBE_COL, PROBE_COL, 0, Panel::HEIGHT - 1);
+    cmd_(0x24);
+    cs_select_(true);
+    dc_data_();
+    write_bytes_(pattern, Panel::HEIGHT);
+    cs_select_(false);
+
+    dirty_[PROBE_COL >> 5] |= 1u << (PROBE_COL & 31);
+    return read_check_(Ctrl::MASTER, PROBE_COL, PROBE_COL, pattern) == 0;
+}
+
+template <typename Traits>
+bool SSD1683<Traits>::upload_suspend()
+{
+    if (hw_armed_)
+        return false; // the chain cannot be parked part-way
+    return step_ == Step::IDLE || end_slice_();
+}
+
+template <typename Traits>
+void SSD1683<Traits>::upload_abort()
+{
+    if (step_ == Step::IDLE)
+        return;
+    if (hw_armed_)
+    {
+        // Too late once the chain has sent the trigger
+        if (hw_poll_())
+            hw_abort_();
+        return;
+    }
+
+    dma_channel_wait_for_finish_blocking(dma_chan_);
+    end_slice_();
+    burst_left_ = 0;
+    step_ = Step::IDLE;
+}
+
+template <typename Traits>
+bool SSD1683<Traits>::enable_hw_sequence()
+{
+    // CS and SCK are one two-pin side-set group
+    if (!inited_ || hw_ || sck_ != cs_ + 1)
+        return false;
+
+    // Patch the BUSY wait for this panel's polarity: wait for the idle level
+    constexpr int N = sizeof(ssd1683_hwseq_program_instructions) / sizeof(ssd1683_hwseq_program_instructions[0]);
+    uint16_t insns[N];
+    memcpy(insns, ssd1683_hwseq_program_instructions, sizeof(insns));
+    insns[ssd1683_hwseq_offset_wait_busy] =
+        (uint16_t)(pio_encode_wait_pin(!Traits::BUSY_ACTIVE_HIGH, 0) | pio_encode_sideset(2, 0b01));
+    pio_program_t prog = ssd1683_hwseq_program;
+    prog.instructions = insns;
+
+    if (!pio_claim_free_sm_and_add_program(&prog, &hw_pio_, &hw_sm_, &hw_offset_))
+        return false;
+    hw_ctrl_chan_ = dma_claim_unused_channel(false);
+    if (hw_ctrl_chan_ < 0)
+    {
+        pio_remove_program_and_unclaim_sm(&prog, hw_pio_, hw_sm_, hw_offset_);
+        return false;
+    }
+
+    const uint32_t pins = (1u << cs_) | (1u << sck_) | (1u << mosi_) | (1u << dc_);
+    pio_sm_config c = ssd1683_hwseq_program_get_default_config(hw_offset_);
+    sm_config_set_sideset_pins(&c, cs_);
+    sm_config_set_out_pins(&c, mosi_, 1);
+    sm_config_set_set_pins(&c, dc_, 1);
+    sm_config_set_in_pins(&c, busy_);
+    sm_config_set_out_shift(&c, false, false, 32); // MSB first, explicit pulls
+    sm_config_set_clkdiv(&c, hwseq_clkdiv(spi_hz_));
+    pio_sm_set_pins_with_mask(hw_pio_, hw_sm_, 1u << cs_, pins); // deselected
+    pio_sm_set_pindirs_with_mask(hw_pio_, hw_sm_, pins, pins);
+    pio_sm_init(hw_pio_, hw_sm_, hw_offset_, &c);
+    pio_sm_set_enabled(hw_pio_, hw_sm_, true); // parked on its first pull
+
+    // Data channel CTRL words for the control blocks: header words, byte runs, and
+    // the terminating null trigger, which raises the data channel's IRQ (IRQ_QUIET)
+    dma_channel_config d = dma_channel_get_default_config(dma_chan_);
+    channel_config_set_read_increment(&d, true);
+    channel_config_set_write_increment(&d, false);
+    channel_config_set_dreq(&d, pio_get_dreq(hw_pio_, hw_sm_, true));
+    channel_config_set_irq_quiet(&d, true);
+    channel_config_set_chain_to(&d, hw_ctrl_chan_);
+    channel_config_set_transfer_data_size(&d, DMA_SIZE_32);
+    hw_ctrl_word_ = channel_config_get_ctrl_value(&d);
+    channel_config_set_transfer_data_size(&d, DMA_SIZE_8); // replicated across the FIFO word
+    hw_ctrl_byte_ = channel_config_get_ctrl_value(&d);
+    channel_config_set_chain_to(&d, dma_chan_); // chaining to itself = no chain
+    hw_ctrl_end_ = channel_config_get_ctrl_value(&d);
+
+    // Control channel: four words per block into the data channel's alias 1 registers
+    dma_channel_config k = dma_channel_get_default_config(hw_ctrl_chan_);
+    channel_config_set_transfer_data_size(&k, DMA_SIZE_32);
+    channel_config_set_read_increment(&k, true);
+    channel_config_set_write_increment(&k, true);
+    channel_config_set_ring(&k, true, 4);
+    dma_channel_configure(hw_ctrl_chan_, &k, &dma_hw->ch[dma_chan_].al1_ctrl, hw_blocks_, 4, false);
+
+    hw_ = true;
+    return true;
+}
+
+template <typename Traits>
+void SSD1683<Traits>::hw_pins_(bool to_pio)
+{
+    if (to_pio)
+    {
+        pio_gpio_init(hw_pio_, cs_);
+        pio_gpio_init(hw_pio_, sck_);
+        pio_gpio_init(hw_pio_, mosi_);
+        pio_gpio_init(hw_pio_, dc_);
+    }
+    else
+    {
+        // SIO still drives CS high and DC at its last level
+        gpio_set_function(cs_, GPIO_FUNC_SIO);
+        gpio_set_function(dc_, GPIO_FUNC_SIO);
+        gpio_set_function(sck_, GPIO_FUNC_SPI);
+        gpio_set_function(mosi_, GPIO_FUNC_SPI);
+    }
+}
+
+// One packet: a header block, then a block for the bytes. The header needs to stay
+// put until the chain has read it, hence hw_headers_.
+template <typename Traits>
+void SSD1683<Traits>::hw_packet_(bool dc, const uint8_t *data, uint32_t n)
+{
+    if (hw_packets_ >= HW_MAX_PACKETS)
+        return; // the sequences built here stay well below
+
+    uint32_t *h = &hw_headers_[hw_packets_++];
+    *h = (hw_wait_next_ ? 1u << 31 : 0u) | (dc ? 1u << 30 : 0u) | (n - 1);
+    hw_wait_next_ = false;
+
+    volatile void *fifo = &hw_pio_->txf[hw_sm_];
+    hw_blocks_[hw_blocks_used_++] = {hw_ctrl_word_, h, fifo, 1};
+    hw_blocks_[hw_blocks_used_++] = {hw_ctrl_byte_, data, fifo, n};
+}
+
+// Command sequence -> packets. WAIT_BUSY gates the next packet; delays have no
+// equivalent in the chain (none of the sequences sent this way use them).
+template <typename Traits>
+void SSD1683<Traits>::hw_seq_(const uint8_t *seq)
+{
+    while (*seq != ssd1683_seq::END)
+    {
+        uint8_t op = *seq++;
+        if (op == ssd1683_seq::WAIT_BUSY)
+        {
+            hw_wait_next_ = true;
+            continue;
+        }
+        if (op == ssd1683_seq::DELAY_MS)
+        {
+            ++seq;
+            continue;
+        }
+
+        hw_packet_(false, seq, 1);
+        if (op > 0)
+            hw_packet_(true, seq + 1, op);
+        seq += 1 + op;
+    }
+}
+
+// Per die, one window over the span from the first to the last dirty column (clean
+// columns inside it are rewritten unchanged), then the refresh trigger. The first
+// packet waits for BUSY, so this may be armed while the previous refresh runs.
+template <typename Traits>
+void SSD1683<Traits>::hw_start_()
+{
+    hw_packets_ = 0;
+    hw_blocks_used_ = 0;
+    hw_wait_next_ = true;
+
+    for (int die = 0; die < (Panel::DUAL ? 2 : 1); ++die)
+    {
+        const bool slave = (die == 1);
+        const int base = slave ? Traits::MASTER_COLS : 0;
+        const int end = slave ? COLS : Traits::MASTER_COLS;
+        const int g0 = ssd1683_bits::next_set(dirty_, base, end);
+        const int g1 = ssd1683_bits::end_of_set(dirty_, g0, end);
+        hw_span_[die][0] = g0;
+        hw_span_[die][1] = g1;
+        if (g0 == g1)
+            continue;
+
+        const int k0 = g0 - base, k1 = g1 - 1 - base;
+        const uint32_t n = (uint32_t)(k1 - k0 + 1) * Panel::HEIGHT;
+        hw_window_[die] = window_seq<Traits>(slave, k0, k1, 0, Panel::HEIGHT - 1);
+        hw_seq_(hw_window_[die].b);
+        hw_packet_(false, &WRITE_RAM_OP[die], 1);
+        hw_packet_(true, (slave ? async_slave_ : async_master_) + k0 * Panel::HEIGHT, n);
+        upload_bytes_ += n;
+    }
+    hw_seq_(SEQ_TRIGGER_FULL.b);
+    hw_blocks_[hw_blocks_used_++] = {hw_ctrl_end_, nullptr, nullptr, 0};
+
+    hw_pins_(true);
+    hw_armed_ = true;
+    dma_channel_set_write_addr(hw_ctrl_chan_, &dma_hw->ch[dma_chan_].al1_ctrl, false);
+    dma_channel_set_read_addr(hw_ctrl_chan_, hw_blocks_, true);
+}
+
+template <typename Traits>
+bool SSD1683<Traits>::hw_poll_()
+{
+    // The chain is done once the control channel has consumed the null block
+    if (dma_channel_is_busy(dma_chan_) || dma_channel_is_busy(hw_ctrl_chan_) ||
+        dma_hw->ch[hw_ctrl_chan_].read_addr != (uint32_t)(uintptr_t)&hw_blocks_[hw_blocks_used_])
+        return true;
+
+    // The last few bytes are still in the FIFO or the shifter: microseconds
+    while (!pio_sm_is_tx_fifo_empty(hw_pio_, hw_sm_) || pio_sm_get_pc(hw_pio_, hw_sm_) != hw_offset_)
+        tight_loop_contents();
+
+    hw_pins_(false);
+    for (const int *span : hw_span_)
+    {
+        for (int g = span[0]; g < span[1]; ++g)
+            dirty_[g >> 5] &= ~(1u << (g & 31));
+    }
+    hw_armed_ = false;
+    step_ = Step::IDLE;
+    return false;
+}
+
+// Stop the chain wherever it is and park the state machine on its first pull with
+// CS high. Columns of an unfinished upload stay dirty.
+template <typename Traits>
+void SSD1683<Traits>::hw_abort_()
+{
+    dma_channel_abort(hw_ctrl_chan_);
+    dma_channel_abort(dma_chan_);
+    dma_channel_abort(hw_ctrl_chan_); // in case the data channel chained to it meanwhile
+
+    pio_sm_set_enabled(hw_pio_, hw_sm_, false);
+    pio_sm_clear_fifos(hw_pio_, hw_sm_);
+    pio_sm_restart(hw_pio_, hw_sm_);
+    pio_sm_exec(hw_pio_, hw_sm_, pio_encode_jmp(hw_offset_) | pio_encode_sideset(2, 0b01));
+    pio_sm_set_enabled(hw_pio_, hw_sm_, true);
+
+    hw_pins_(false);
+    hw_armed_ = false;
+    step_ = Step::IDLE;
+}
+
+SSD1683_INSTANTIATE(PanelGDEY0579T93)
+SSD1683_INSTANTIATE(PanelGDEY042T81)
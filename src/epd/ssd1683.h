@@ -0,0 +1,271 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "pico/stdlib.h"
+#include "hardware/pio.h"
+#include "hardware/spi.h"
+
+#include "ssd1683_panel.h"
+#include "ssd1683_seq.h"
+
+// SSD1683-family driver, specialized at compile time for one panel (see ssd1683_panel.h).
+// Covers single-controller glass (e.g. 400x300) and two-die cascades with a shared
+// seam column. Geometry, controller split, wire transform and BUSY polarity all come
+// from Traits, so every panel shares the same DMA upload path with no per-byte checks.
+//
+// Member definitions live in ssd1683.cpp, which explicitly instantiates the driver
+// for every supported panel and orientation (SSD1683_INSTANTIATE below).
+template <typename Traits>
+class SSD1683 : public SSD1683Panel<Traits>
+{
+public:
+    using Panel = SSD1683Panel<Traits>;
+
+    SSD1683(spi_inst_t *spi,
+            uint pin_cs, uint pin_dc, uint pin_rst, uint pin_busy,
+            uint pin_sck, uint pin_mosi);
+
+    // Several panels may share one SPI instance (separate CS/DC/RST/BUSY pins);
+    // init() each of them with the same spi_hz. False if the controller never
+    // released BUSY after its software reset.
+    bool init(uint32_t spi_hz);
+
+    // Recovery: drop any upload, pulse RST and redo the controller setup. RAM
+    // contents are lost. False if BUSY is still stuck after timeout_ms.
+    bool reset(uint32_t timeout_ms);
+
+    // Full-screen write from a row-major buffer (converted with ssd1683_transform_rowmajor).
+    // frame format: row-major, top row first, MSB = left pixel in each byte,
+    // FRAME_WIDTH x FRAME_HEIGHT (the panel's orientation is applied during conversion).
+    void show_full_fullscreen(const uint8_t *frame);
+
+    // Full-screen write from planes already in controller RAM order (no transposition).
+    // Each plane goes out as a single DMA burst. slave_plane is unused on single-controller panels.
+    void show_full_native(const uint8_t *master_plane, const uint8_t *slave_plane);
+
+    // Non-blocking variant. start_full_native() issues the window setup and starts the
+    // first DMA burst; each upload_poll() after the DMA channel finishes starts the next
+    // burst, and the last one triggers the refresh. Nothing waits on BUSY, so panels
+    // sharing one SPI bus can overlap their refresh cycles. The planes must stay
+    // untouched until upload_poll() returns false; start only when !busy() (or when
+    // queues_while_busy()).
+    //
+    // Only plane columns that changed since the previous upload are rewritten (see the
+    // RAM shadow below); the refresh itself is always a full one. When nothing changed
+    // the refresh is triggered right away and no DMA completion follows.
+    void start_full_native(const uint8_t *master_plane, const uint8_t *slave_plane);
+
+    // Advance an async upload; true while it is still in flight
+    bool upload_poll();
+    bool uploading() const { return step_ != Step::IDLE; }
+
+    // Bursts go out in slices of at most n bytes (0 = whole plane). Between slices CS
+    // is released on request, which bounds how long another panel waits for the bus.
+    void set_slice_bytes(uint32_t n) { slice_bytes_ = n; }
+
+    // Release the bus after the current slice so another panel can use it; false while
+    // the slice is still in flight. The next upload_poll() continues where it stopped.
+    bool upload_suspend();
+
+    // Drop an upload before its refresh is triggered (waits out the current slice).
+    // RAM holds a partial frame until the next start_full_native().
+    void upload_abort();
+
+    // Plane bytes sent by the last upload (both controllers, "old" buffer included)
+    uint32_t last_upload_bytes() const { return upload_bytes_; }
+
+    // Forget the RAM shadow: the next upload rewrites every column
+    void invalidate_shadow() { shadow_valid_ = false; }
+
+    // Read plane columns [g0, g1) back from controller RAM (master columns, then
+    // slave columns, as in the shadow) and CRC-check them against the planes that
+    // were uploaded. Mismatching columns are marked dirty, so the next upload
+    // rewrites only those. Returns the number of mismatches, or -1 while an upload
+    // or refresh is running. Blocking: reads are bit-banged over the shared SDA line,
+    // so no other panel may be using the bus.
+    int verify_ram(const uint8_t *master_plane, const uint8_t *slave_plane, int g0, int g1);
+    static constexpr int plane_columns() { return COLS; }
+
+    // SPI clock for every panel on this SPI instance; returns the rate actually set
+    uint32_t set_spi_hz(uint32_t hz);
+
+    // Calibration probe: write a test pattern into one RAM column at hz and read it
+    // back. Leaves the clock at hz. The column is re-uploaded with the next frame.
+    // False on a mismatch, or while an upload or refresh is running.
+    bool probe_spi(uint32_t hz);
+
+    // Hardware-sequenced uploads. A PIO state machine takes over CS/SCK/MOSI/DC for
+    // the duration of an upload: it waits for BUSY to release, then a pre-armed DMA
+    // control-block chain streams the window setup, the dirty plane columns and the
+    // refresh trigger, with no CPU involvement between refreshes. start_full_native()
+    // may then be called while the previous refresh is still running (see
+    // queues_while_busy()); completion arrives as one DMA IRQ at the end of the chain.
+    // Needs SCK wired to the pin right after CS and the SPI bus to this panel alone.
+    // SCK runs at the calibrated rate, but per-byte overhead puts the byte rate ~16%
+    // below the CPU/DMA path's (see hwseq_clkdiv).
+    bool enable_hw_sequence();
+    bool queues_while_busy() const { return hw_ && !old_stale_; }
+
+    // For routing this driver's DMA completion IRQ (DMA_IRQ_0/1) to upload_poll()
+    int dma_channel() const { return dma_chan_; }
+
+    void clear_to_white();
+
+    // Busy wait (true = success)
+    bool wait_idle(uint32_t timeout_ms);
+
+    // Instantaneous BUSY pin state
+    bool busy() const;
+
+private:
+    spi_inst_t *spi_;
+    uint cs_, dc_, rst_, busy_, sck_, mosi_;
+    bool inited_ = false;
+    int dma_chan_ = -1;
+    uint8_t fill_byte_ = 0; // DMA source for data_fill_
+
+    // Async upload sequence (one DMA burst per step)
+    enum class Step : uint8_t
+    {
+        IDLE,
+        NEW, // dirty column runs into the "new" buffer
+        MASTER_OLD,
+        SLAVE_OLD
+    };
+    Step step_ = Step::IDLE;
+    const uint8_t *async_master_ = nullptr;
+    const uint8_t *async_slave_ = nullptr;
+
+    // RAM shadow: a hash per plane column (master columns, then slave columns) of what
+    // the controller RAM holds. A plane column is HEIGHT contiguous bytes, so a run of
+    // dirty columns is one window and one burst.
+    static constexpr int COLS = Traits::MASTER_COLS + Traits::SLAVE_COLS;
+    static constexpr int PROBE_COL = Traits::MASTER_COLS / 2; // calibration scratch column
+    uint32_t col_hash_[COLS] = {};
+    uint32_t dirty_[(COLS + 31) / 32] = {}; // written to RAM by no upload yet
+    bool shadow_valid_ = false;
+    bool old_stale_ = true; // "old" buffers not known to be cleared
+    int run_next_ = 0;      // next column to scan for a dirty run
+    int run_g0_ = 0, run_g1_ = 0;
+    uint32_t upload_bytes_ = 0;
+    uint32_t spi_hz_ = 0;
+
+    // Hardware sequence: packets are a header word plus a byte run, each one DMA
+    // control block (alias 1 layout: CTRL, READ_ADDR, WRITE_ADDR, TRANS_COUNT_TRIG)
+    struct DmaBlock
+    {
+        uint32_t ctrl;
+        const void *read;
+        volatile void *write;
+        uint32_t count;
+    };
+    static constexpr int HW_MAX_PACKETS = 32;
+
+    bool hw_ = false;
+    bool hw_armed_ = false;
+    PIO hw_pio_ = nullptr;
+    uint hw_sm_ = 0;
+    uint hw_offset_ = 0;
+    int hw_ctrl_chan_ = -1;
+    uint32_t hw_ctrl_word_ = 0, hw_ctrl_byte_ = 0, hw_ctrl_end_ = 0; // data channel CTRL values
+    int hw_packets_ = 0;
+    int hw_blocks_used_ = 0;
+    bool hw_wait_next_ = false;
+    int hw_span_[2][2] = {}; // dirty column span per die, cleared on completion
+    uint32_t hw_headers_[HW_MAX_PACKETS];
+    DmaBlock hw_blocks_[2 * HW_MAX_PACKETS + 1];
+    ssd1683_seq::Seq<24> hw_window_[2];
+
+    // Current burst, sent one slice at a time
+    const uint8_t *burst_src_ = nullptr;
+    uint32_t burst_left_ = 0;
+    bool burst_inc_ = true;
+    bool slice_open_ = false; // CS held low for a slice
+    uint32_t slice_bytes_ = 0;
+
+    void cs_select_(bool en);
+    void dc_cmd_();
+    void dc_data_();
+
+    void write_u8_(uint8_t v);
+    void write_bytes_(const uint8_t *data, size_t n);
+
+    // DMA to the SPI TX FIFO; returns once the last bit has left the shifter
+    void write_dma_(const uint8_t *data, size_t n, bool increment);
+    void dma_start_(const uint8_t *data, size_t n, bool increment);
+    void dma_drain_();
+
+    // Open a data phase (CS low, DC high) and start its DMA without waiting
+    void begin_burst_(const uint8_t *data, size_t n);
+    void begin_fill_(uint8_t v, size_t n);
+    void next_slice_();
+    bool end_slice_(); // false while the slice's DMA is still running
+    void data_burst_(const uint8_t *data, size_t n);
+    void data_fill_(uint8_t v, size_t n);
+
+    void cmd_(uint8_t c);
+
+    // 3-wire read: SDA is bidirectional, so after the opcode SCK/SDA leave the SPI
+    // block and the data phase is clocked by hand (slow: reads are diagnostics)
+    void read_begin_(uint8_t c);
+    uint8_t read_u8_();
+    void read_end_();
+    // Interpret a command sequence (ssd1683_seq.h); false if a BUSY wait timed out
+    bool run_seq_(const uint8_t *seq, uint32_t timeout_ms);
+    void reset_();
+    bool setup_controller_(uint32_t timeout_ms);
+
+    // Command-set selector: the slave die answers to the master opcodes | 0x80
+    enum class Ctrl : uint8_t
+    {
+        MASTER = 0x00,
+        SLAVE = 0x80
+    };
+
+    // RAM window over plane byte columns [k0, k1] and rows [y0, y1] (inclusive),
+    // cursor parked at the start of the column-major, bottom-up walk
+    void set_ram_window_(Ctrl ctrl, int k0, int k1, int y0, int y1);
+    void set_full_window_(Ctrl ctrl); // precomputed whole-plane window
+    int read_check_(Ctrl ctrl, int k0, int k1, const uint8_t *expect);
+
+    // Null plane pointer = fill that plane with fill (wire byte)
+    void write_plane_(Ctrl ctrl, const uint8_t *plane, size_t n, uint8_t fill);
+    void upload_(const uint8_t *master_plane, const uint8_t *slave_plane, uint8_t fill);
+
+    // Hardware sequence: build the packet chain for the dirty columns and arm it
+    void hw_packet_(bool dc, const uint8_t *data, uint32_t n);
+    void hw_seq_(const uint8_t *seq);
+    void hw_start_();
+    bool hw_poll_(); // false once the chain has drained and the pins are back
+    void hw_abort_();
+    void hw_pins_(bool to_pio);
+
+    void mark_dirty_(const uint8_t *master_plane, const uint8_t *slave_plane);
+    bool next_run_();
+    bool advance_(); // start the next burst; false once the refresh is triggered
+    void upload_sync_(const uint8_t *master_plane, const uint8_t *slave_plane);
+
+    void trigger_full_();
+    void update_full_();
+};
+
+// Explicit instantiations for a panel in every mounting orientation. Unused ones
+// are dropped by --gc-sections.
+#define SSD1683_FOR_EACH_ORIENTATION(X, PANEL)  \
+    X(PANEL)                                    \
+    X(SSD1683Rotated<PANEL, 0>)                 \
+    X(SSD1683Rotated<PANEL, 90>)                \
+    X(SSD1683Rotated<PANEL, 180>)               \
+    X(SSD1683Rotated<PANEL, 270>)               \
+    X(SSD1683Rotated<PANEL, 0, true>)           \
+    X(SSD1683Rotated<PANEL, 90, true>)          \
+    X(SSD1683Rotated<PANEL, 180, true>)         \
+    X(SSD1683Rotated<PANEL, 270, true>)
+
+#define SSD1683_EXTERN_ONE_(...) extern template class SSD1683<__VA_ARGS__>;
+#define SSD1683_INSTANTIATE_ONE_(...) template class SSD1683<__VA_ARGS__>;
+
+#define SSD1683_EXTERN(PANEL) SSD1683_FOR_EACH_ORIENTATION(SSD1683_EXTERN_ONE_, PANEL)
+#define SSD1683_INSTANTIATE(PANEL) SSD1683_FOR_EACH_ORIENTATION(SSD1683_INSTANTIATE_ONE_, PANEL)
@@ -0,0 +1,227 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+// Word-at-a-time 1bpp kernels shared by the frame, transform and driver code.
+//
+// Each kernel works on 32 bits per step. Both RP2350 core types have single
+// instructions for the bit-level steps:
+//
+//                  Cortex-M33 (DSP)   Hazard3 (Zbb/Zbkb)
+//   rev_each_byte  RBIT + REV         BREV8              bit mirror of four packed bytes
+//   popcount       SWAR + USAD8       CPOP
+//   ctz / clz      RBIT + CLZ, CLZ    CTZ, CLZ           first/last differing byte, runs
+//   bswap32        REV                REV8               row shifts
+//
+// Elsewhere (host builds of the kernels) the same results come from shifts and masks.
+// Buffers are little-endian words: byte i of a buffer is bits [8i, 8i+8) of its word.
+namespace ssd1683_bits
+{
+#if defined(__ARM_FEATURE_DSP) && defined(__thumb2__)
+#define SSD1683_BITS_DSP 1
+#else
+#define SSD1683_BITS_DSP 0
+#endif
+
+#if defined(__riscv_zbb) && defined(__riscv_zbkb)
+#define SSD1683_BITS_ZBB 1
+#else
+#define SSD1683_BITS_ZBB 0
+#endif
+
+    // Which kernel set this build uses (kernel_bench prints it)
+    static constexpr const char *ARCH = SSD1683_BITS_DSP ? "m33-dsp" : SSD1683_BITS_ZBB ? "hazard3-zbb" : "generic";
+
+    static inline uint32_t load_u32(const uint8_t *p)
+    {
+        uint32_t v;
+        memcpy(&v, p, 4);
+        return v;
+    }
+
+    static inline void store_u32(uint8_t *p, uint32_t v)
+    {
+        memcpy(p, &v, 4);
+    }
+
+    // Bit-reverse each byte of w in place (constexpr form, for tables)
+    static constexpr uint32_t rev_each_byte_c(uint32_t w)
+    {
+        w = ((w >> 4) & 0x0F0F0F0Fu) | ((w & 0x0F0F0F0Fu) << 4);
+        w = ((w >> 2) & 0x33333333u) | ((w & 0x33333333u) << 2);
+        w = ((w >> 1) & 0x55555555u) | ((w & 0x55555555u) << 1);
+        return w;
+    }
+
+#if SSD1683_BITS_ZBB
+    static inline uint32_t brev8(uint32_t w)
+    {
+        uint32_t r;
+        __asm__("brev8 %0, %1" : "=r"(r) : "r"(w));
+        return r;
+    }
+#endif
+
+    static inline uint32_t rbit(uint32_t w)
+    {
+#if SSD1683_BITS_DSP
+        uint32_t r;
+        __asm__("rbit %0, %1" : "=r"(r) : "r"(w));
+        return r;
+#elif SSD1683_BITS_ZBB
+        return __builtin_bswap32(brev8(w));
+#else
+        return __builtin_bswap32(rev_each_byte_c(w));
+#endif
+    }
+
+    // M33: RBIT mirrors the whole word and REV puts the bytes back in place.
+    // Hazard3 has the per-byte mirror as one instruction.
+    static inline uint32_t rev_each_byte(uint32_t w)
+    {
+#if SSD1683_BITS_DSP
+        return __builtin_bswap32(rbit(w));
+#elif SSD1683_BITS_ZBB
+        return brev8(w);
+#else
+        return rev_each_byte_c(w);
+#endif
+    }
+
+    static inline uint8_t rev8(uint8_t b)
+    {
+#if SSD1683_BITS_ZBB
+        return (uint8_t)brev8(b);
+#else
+        return (uint8_t)(rbit(b) >> 24);
+#endif
+    }
+
+    // x != 0 for both
+    static inline int ctz(uint32_t x) { return __builtin_ctz(x); }
+    static inline int clz(uint32_t x) { return __builtin_clz(x); }
+
+    static inline int popcount(uint32_t x)
+    {
+#if SSD1683_BITS_ZBB
+        return __builtin_popcount(x); // CPOP
+#else
+        x -= (x >> 1) & 0x55555555u;
+        x = (x & 0x33333333u) + ((x >> 2) & 0x33333333u);
+        x = (x + (x >> 4)) & 0x0F0F0F0Fu; // four byte counts, 0..8 each
+#if SSD1683_BITS_DSP
+        uint32_t n;
+        __asm__("usad8 %0, %1, %2" : "=r"(n) : "r"(x), "r"(0u));
+        return (int)n;
+#else
+        return (int)((x * 0x01010101u) >> 24);
+#endif
+#endif
+    }
+
+    // First and last byte where a and b differ, by XOR of whole words. n must be a
+    // multiple of 4. False (lo/hi untouched) when the buffers are equal.
+    static inline bool diff_span(const uint8_t *a, const uint8_t *b, int n, int &lo, int &hi)
+    {
+        int i = 0;
+        uint32_t x = 0;
+        for (; i < n; i += 4)
+        {
+            x = load_u32(a + i) ^ load_u32(b + i);
+            if (x)
+                break;
+        }
+        if (i >= n)
+            return false;
+        lo = i + (ctz(x) >> 3);
+
+        int k = n - 4;
+        while ((x = load_u32(a + k) ^ load_u32(b + k)) == 0)
+            k -= 4;
+        hi = k + 3 - (clz(x) >> 3);
+        return true;
+    }
+
+    // Pixels (bits) that differ between a and b. n must be a multiple of 4.
+    static inline uint32_t diff_count(const uint8_t *a, const uint8_t *b, int n)
+    {
+        uint32_t count = 0;
+        for (int i = 0; i < n; i += 4)
+            count += (uint32_t)popcount(load_u32(a + i) ^ load_u32(b + i));
+        return count;
+    }
+
+    // Run scanning over a bitset (bit i = word i / 32, bit i % 32).
+    // First set bit in [i, n), or n
+    static inline int next_set(const uint32_t *bits, int i, int n)
+    {
+        while (i < n)
+        {
+            uint32_t w = bits[i >> 5] >> (i & 31);
+            if (w)
+            {
+                i += ctz(w);
+                return i < n ? i : n;
+            }
+            i = (i | 31) + 1;
+        }
+        return n;
+    }
+
+    // First clear bit in [i, n), or n
+    static inline int next_clear(const uint32_t *bits, int i, int n)
+    {
+        while (i < n)
+        {
+            uint32_t w = ~bits[i >> 5] >> (i & 31);
+            if (w)
+            {
+                i += ctz(w);
+                return i < n ? i : n;
+            }
+            i = (i | 31) + 1;
+        }
+        return n;
+    }
+
+    // One past the last set bit in [lo, hi), or lo
+    static inline int end_of_set(const uint32_t *bits, int lo, int hi)
+    {
+        while (hi > lo)
+        {
+            const int k = (hi - 1) >> 5;
+            uint32_t w = bits[k] & (0xFFFFFFFFu >> (31 - ((hi - 1) & 31)));
+            if (w)
+            {
+                int e = k * 32 + 32 - clz(w);
+                return e > lo ? e : lo;
+            }
+            hi = k * 32;
+        }
+        return lo;
+    }
+
+    // dst[k] = the 8 source bits starting shift bits into src[k] (MSB-first rows),
+    // 0 <= shift < 8. Reads src[0, n], or src[0, n) when shift is 0. dst may equal
+    // src or lie below it. Four bytes per step: REV turns the word big-endian so
+    // one shift moves bits across byte boundaries.
+    static inline void shift_row(uint8_t *dst, const uint8_t *src, int n, int shift)
+    {
+        if (shift == 0)
+        {
+            memmove(dst, src, (size_t)n);
+            return;
+        }
+
+        int k = 0;
+        for (; k + 4 <= n; k += 4)
+        {
+            uint32_t w = __builtin_bswap32(load_u32(src + k));
+            w = (w << shift) | ((uint32_t)src[k + 4] >> (8 - shift));
+            store_u32(dst + k, __builtin_bswap32(w));
+        }
+        for (; k < n; ++k)
+            dst[k] = (uint8_t)((src[k] << shift) | (src[k + 1] >> (8 - shift)));
+    }
+}
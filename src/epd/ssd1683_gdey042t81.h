@@ -0,0 +1,27 @@
+#pragma once
+
+#include "ssd1683.h"
+
+// GoodDisplay GDEY042T81: 400x300, single SSD1683.
+struct PanelGDEY042T81
+{
+    static constexpr int WIDTH = 400;
+    static constexpr int HEIGHT = 300;
+
+    static constexpr int MASTER_COLS = 50; // bytes
+    static constexpr int SLAVE_COLS = 0;   // no slave die
+    static constexpr int SLAVE_START = 50;
+
+    static constexpr bool INVERT_BYTES = false;
+    static constexpr bool BIT_REVERSE = false;
+
+    static constexpr bool BUSY_ACTIVE_HIGH = true;
+
+    // Mounted as-is; wrap in SSD1683Rotated for other orientations
+    static constexpr int ROTATION = 0;
+    static constexpr bool MIRROR_X = false;
+};
+
+using SSD1683_GDEY042T81 = SSD1683<PanelGDEY042T81>;
+
+SSD1683_EXTERN(PanelGDEY042T81)
@@ -0,0 +1,384 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "ssd1683_bits.h"
+#include "ssd1683_panel.h"
+#include "ssd1683_transform.h"
+#include "ssd1683_walk.h"
+
+// Framebuffer stored in the controllers' own RAM write order, so an upload is
+// one contiguous burst per plane instead of a strided walk of a row-major frame.
+//
+// Plane layout (matches SSD1683::set_ram_window_: column-major, Y is the fast axis):
+//   master[c * HEIGHT + plane_off(py)]                 for glass byte columns [0, MASTER_COLS)
+//   slave [(c - SLAVE_START) * HEIGHT + plane_off(py)] for glass byte columns [SLAVE_START, BYTES_PER_ROW)
+// plane_off(py) is HEIGHT - 1 - py, or py when the orientation uses a Y-increment entry mode.
+// The overlap column lives in both planes; drawing keeps the copies equal.
+//
+// Drawing takes frame coordinates (FRAME_WIDTH x FRAME_HEIGHT, i.e. after rotation);
+// a rectangle maps to a glass rectangle, so rotation costs nothing per pixel.
+// Bytes are stored already transformed for the wire, i.e. exactly what is uploaded.
+template <typename Traits>
+class SSD1683NativeFrame
+{
+public:
+    using Panel = SSD1683Panel<Traits>;
+
+    static constexpr int WIDTH = Panel::FRAME_WIDTH;
+    static constexpr int HEIGHT = Panel::FRAME_HEIGHT;
+    static constexpr int MASTER_BYTES = Panel::MASTER_PLANE_BYTES;
+    static constexpr int SLAVE_BYTES = Panel::SLAVE_PLANE_BYTES;
+
+    // Plane columns are compared a word at a time (ssd1683_bits)
+    static_assert(Panel::HEIGHT % 4 == 0, "HEIGHT must be a multiple of 4");
+
+    // Word aligned for the transform kernel's 32-bit stores
+    alignas(4) uint8_t master[MASTER_BYTES];
+    alignas(4) uint8_t slave[SLAVE_BYTES > 0 ? SLAVE_BYTES : 1];
+
+    void clear(bool black = false)
+    {
+        uint8_t v = Panel::xform(black ? 0x00 : 0xFF);
+        memset(master, v, sizeof(master));
+        memset(slave, v, sizeof(slave));
+    }
+
+    // black = true draws a black pixel (row-major 0 bit)
+    void set_pixel(int x, int y, bool black)
+    {
+        if (x < 0 || x >= WIDTH || y < 0 || y >= HEIGHT)
+            return;
+
+        int px, py;
+        Panel::to_glass(x, y, px, py);
+        apply_column_(px / 8, py, py + 1, (uint8_t)(0x80u >> (px % 8)), black);
+    }
+
+    bool get_pixel(int x, int y) const
+    {
+        if (x < 0 || x >= WIDTH || y < 0 || y >= HEIGHT)
+            return false;
+
+        int px, py;
+        Panel::to_glass(x, y, px, py);
+
+        int c = px / 8;
+        uint8_t b = (c < Panel::MASTER_COLS)
+                        ? master[c * Panel::HEIGHT + Panel::plane_off(py)]
+                        : slave[(c - Panel::SLAVE_START) * Panel::HEIGHT + Panel::plane_off(py)];
+
+        // The wire transform is an involution, so it also undoes itself
+        b = Panel::xform(b);
+        return (b & (0x80u >> (px % 8))) == 0;
+    }
+
+    // Clipped to the frame
+    void fill_rect(int x, int y, int w, int h, bool black)
+    {
+        int x0 = x < 0 ? 0 : x;
+        int y0 = y < 0 ? 0 : y;
+        int x1 = (x + w > WIDTH) ? WIDTH : x + w;
+        int y1 = (y + h > HEIGHT) ? HEIGHT : y + h;
+        if (x0 >= x1 || y0 >= y1)
+            return;
+
+        // Opposite corners -> glass rectangle [gx0, gx1) x [gy0, gy1)
+        int ax, ay, bx, by;
+        Panel::to_glass(x0, y0, ax, ay);
+        Panel::to_glass(x1 - 1, y1 - 1, bx, by);
+        int gx0 = ax < bx ? ax : bx, gx1 = (ax < bx ? bx : ax) + 1;
+        int gy0 = ay < by ? ay : by, gy1 = (ay < by ? by : ay) + 1;
+
+        // One masked pass per touched byte column
+        for (int c = gx0 / 8; c <= (gx1 - 1) / 8; ++c)
+        {
+            int bx0 = c * 8;
+            int lo = (gx0 > bx0) ? gx0 - bx0 : 0;     // first bit (from MSB) inside this byte
+            int hi = (gx1 < bx0 + 8) ? gx1 - bx0 : 8; // one past last bit
+            uint8_t m = (uint8_t)((0xFFu >> lo) & (0xFFu << (8 - hi)));
+            apply_column_(c, gy0, gy1, m, black);
+        }
+    }
+
+    void hline(int x, int y, int w, bool black) { fill_rect(x, y, w, 1, black); }
+    void vline(int x, int y, int h, bool black) { fill_rect(x, y, 1, h, black); }
+
+    // Conversion path for row-major input (top row first, MSB = left pixel)
+    void load_row_major(const uint8_t *frame)
+    {
+        ssd1683_transform_rowmajor<Traits>(frame, master, slave);
+    }
+
+    // Copy a row-major 1bpp rect (MSB = left, stride bytes per row) to frame (x, y),
+    // clipped to the frame. Meant for small updates (glyphs, caret); full frames go
+    // through load_row_major.
+    //
+    // 0/180 degrees: frame rows are glass rows, so each source row becomes one masked
+    // byte per glass byte column (Walk does the index arithmetic, see ssd1683_walk.h).
+    // 90/270: a source row is one glass bit column, walked a plane byte per pixel.
+    template <typename Walk = SSD1683BlitWalk>
+    void blit_row_major(int x, int y, int w, int h, const uint8_t *src, int stride)
+    {
+        int i0 = x < 0 ? -x : 0, i1 = (x + w > WIDTH) ? WIDTH - x : w;
+        int j0 = y < 0 ? -y : 0, j1 = (y + h > HEIGHT) ? HEIGHT - y : h;
+        if (i0 >= i1 || j0 >= j1)
+            return;
+
+        if constexpr (Panel::TRANSPOSED)
+            blit_bit_columns_(x, y, i0, i1, j0, j1, src, stride);
+        else
+            blit_byte_rows_<Walk>(x, y, i0, i1, j0, j1, src, stride, (w + 7) / 8);
+    }
+
+    // Move frame rect (x, y, w, h) by (dx, dy) pixels, clipped so that source and
+    // destination both lie in the frame. Overlap behaves like memmove; pixels the
+    // copy uncovers keep their old value (the caller draws over them).
+    //
+    // Row by row: the source row is read back into row-major form, aligned to bit 0
+    // with the word-wise row shift, and written with blit_row_major. Rows go bottom
+    // up when moving down, so no source row is overwritten before it is read.
+    void copy_rect(int x, int y, int w, int h, int dx, int dy)
+    {
+        int x0 = x, x1 = x + w, y0 = y, y1 = y + h;
+        if (x0 < 0)
+            x0 = 0;
+        if (x0 + dx < 0)
+            x0 = -dx;
+        if (x1 > WIDTH)
+            x1 = WIDTH;
+        if (x1 + dx > WIDTH)
+            x1 = WIDTH - dx;
+        if (y0 < 0)
+            y0 = 0;
+        if (y0 + dy < 0)
+            y0 = -dy;
+        if (y1 > HEIGHT)
+            y1 = HEIGHT;
+        if (y1 + dy > HEIGHT)
+            y1 = HEIGHT - dy;
+        if (x0 >= x1 || y0 >= y1 || (dx == 0 && dy == 0))
+            return;
+
+        const int n = x1 - x0;
+        uint8_t row[ROW_BYTES_];
+        for (int k = 0; k < y1 - y0; ++k)
+        {
+            const int j = (dy > 0) ? y1 - 1 - k : y0 + k;
+            read_row_(x0, j, n, row);
+            blit_row_major(x0 + dx, j + dy, n, 1, row, ROW_BYTES_);
+        }
+    }
+
+    // Glass-space bounding box of the bytes that differ from other: byte columns
+    // [c0, c1) x rows [y0, y1). Returns false when the frames are identical.
+    bool diff_bounds(const SSD1683NativeFrame &other, int &c0, int &c1, int &y0, int &y1) const
+    {
+        c0 = Panel::BYTES_PER_ROW;
+        c1 = 0;
+        y0 = Panel::HEIGHT;
+        y1 = 0;
+
+        for (int c = 0; c < Panel::BYTES_PER_ROW; ++c)
+        {
+            const uint8_t *a = column_(c);
+            const uint8_t *b = other.column_(c);
+
+            // First/last differing plane offset -> glass rows (plane_off is its own inverse)
+            int lo, hi;
+            if (!ssd1683_bits::diff_span(a, b, Panel::HEIGHT, lo, hi))
+                continue;
+            int ya = Panel::plane_off(lo), yb = Panel::plane_off(hi);
+            if (ya > yb)
+            {
+                int t = ya;
+                ya = yb;
+                yb = t;
+            }
+
+            if (c < c0)
+                c0 = c;
+            c1 = c + 1;
+            if (ya < y0)
+                y0 = ya;
+            if (yb + 1 > y1)
+                y1 = yb + 1;
+        }
+        return c1 > 0;
+    }
+
+    // Number of glass pixels that differ from other
+    uint32_t diff_pixels(const SSD1683NativeFrame &other) const
+    {
+        uint32_t n = 0;
+        for (int c = 0; c < Panel::BYTES_PER_ROW; ++c)
+            n += ssd1683_bits::diff_count(column_(c), other.column_(c), Panel::HEIGHT);
+        return n;
+    }
+
+private:
+    static constexpr int ROW_BYTES_ = Panel::FRAME_BPR + 1;
+
+    // Frame pixels [x, x + n) of row y -> row-major bits starting at dst[0]'s MSB
+    void read_row_(int x, int y, int n, uint8_t *dst) const
+    {
+        if constexpr (Panel::TRANSPOSED)
+        {
+            // A frame row is a glass bit column: one plane byte per pixel
+            memset(dst, 0xFF, (size_t)(n + 7) / 8);
+            for (int i = 0; i < n; ++i)
+            {
+                if (get_pixel(x + i, y))
+                    dst[i >> 3] &= (uint8_t)~(0x80u >> (i & 7));
+            }
+        }
+        else
+        {
+            // A frame row is a glass row: frame byte k sits in glass byte column k
+            // (BYTES_PER_ROW - 1 - k mirrored, then bit-reversed too)
+            constexpr bool XREV = Panel::X_REVERSE;
+            int px, py;
+            Panel::to_glass(x, y, px, py);
+            const int off = Panel::plane_off(py);
+
+            uint8_t bytes[ROW_BYTES_ + 1];
+            const int k0 = x >> 3, k1 = (x + n - 1) >> 3;
+            for (int k = k0; k <= k1; ++k)
+            {
+                const int c = XREV ? Panel::BYTES_PER_ROW - 1 - k : k;
+                uint8_t v = Panel::xform(column_(c)[off]); // the wire transform undoes itself
+                bytes[k - k0] = XREV ? ssd1683_bits::rev8(v) : v;
+            }
+            bytes[k1 - k0 + 1] = 0xFF;
+            ssd1683_bits::shift_row(dst, bytes, (n + 7) / 8, x & 7);
+        }
+    }
+
+    // Source rows -> glass rows; source bits [i0, i1) of rows [j0, j1)
+    template <typename Walk>
+    void blit_byte_rows_(int x, int y, int i0, int i1, int j0, int j1, const uint8_t *src, int stride, int src_bytes)
+    {
+        constexpr bool XREV = Panel::X_REVERSE;
+        constexpr int H = Panel::HEIGHT;
+
+        int ax, bx, py;
+        Panel::to_glass(x + i0, y + j0, ax, py);
+        Panel::to_glass(x + i1 - 1, y + j0, bx, py);
+        const int gx0 = ax < bx ? ax : bx, gx1 = (ax < bx ? bx : ax) + 1;
+        const int c0 = gx0 / 8, c1 = (gx1 - 1) / 8;
+        const uint8_t m0 = (uint8_t)(0xFFu >> (gx0 - 8 * c0));
+        const uint8_t m1 = (uint8_t)(0xFFu << (8 * c1 + 8 - gx1));
+
+        // Source bit under the MSB of glass byte column c: 8c - x, or W - 8 - x - 8c
+        // mirrored (then read backwards). Its alignment is the same for every column.
+        const int b0 = XREV ? (Panel::WIDTH - 8 - x - 8 * c0) : (8 * c0 - x);
+        const int r = b0 & 7;
+        constexpr int dk = XREV ? -1 : 1;
+
+        // Offsets are into the master plane; the same column in the slave plane
+        // (overlap column included) is SLAVE_START columns further down
+        constexpr int to_slave = -Panel::SLAVE_START * H;
+
+        Walk walk(8 - r, H);
+        for (int j = j0; j < j1; ++j)
+        {
+            Panel::to_glass(x + i0, y + j, ax, py);
+            const uint8_t *row = src + j * stride;
+            auto at = [&](int k) -> uint32_t
+            { return (unsigned)k < (unsigned)src_bytes ? row[k] : 0u; };
+
+            walk.row(c0 * H + Panel::plane_off(py));
+            int k = b0 >> 3; // floor: b0 may be negative
+            for (int c = c0; c <= c1; ++c, k += dk)
+            {
+                int o;
+                uint8_t v = walk.next((at(k) << 8) | at(k + 1), o);
+
+                uint8_t m = (uint8_t)((c == c0 ? m0 : 0xFF) & (c == c1 ? m1 : 0xFF));
+                uint8_t wm = Panel::wire_mask(m);
+                uint8_t wv = Panel::template xform_rev<XREV>(v);
+
+                if (c < Panel::MASTER_COLS)
+                    master[o] = (uint8_t)((master[o] & ~wm) | (wv & wm));
+                if (Panel::DUAL && c >= Panel::SLAVE_START)
+                    slave[o + to_slave] = (uint8_t)((slave[o + to_slave] & ~wm) | (wv & wm));
+            }
+        }
+    }
+
+    // Source rows -> glass bit columns: pixel i of a row is one bit in plane byte
+    // plane_off(py(i)), which moves by one byte per pixel
+    void blit_bit_columns_(int x, int y, int i0, int i1, int j0, int j1, const uint8_t *src, int stride)
+    {
+        for (int j = j0; j < j1; ++j)
+        {
+            int px, pa, pb;
+            Panel::to_glass(x + i1 - 1, y + j, px, pb);
+            Panel::to_glass(x + i0, y + j, px, pa);
+            const int c = px / 8;
+            const uint8_t wm = Panel::wire_mask((uint8_t)(0x80u >> (px % 8)));
+            const int o0 = Panel::plane_off(pa);
+            const int step = (Panel::plane_off(pb) >= o0) ? 1 : -1;
+
+            uint8_t *planes[2] = {
+                (c < Panel::MASTER_COLS) ? &master[c * Panel::HEIGHT + o0] : nullptr,
+                (Panel::DUAL && c >= Panel::SLAVE_START) ? &slave[(c - Panel::SLAVE_START) * Panel::HEIGHT + o0] : nullptr,
+            };
+            const uint8_t *row = src + j * stride;
+            for (uint8_t *p : planes)
+            {
+                if (!p)
+                    continue;
+
+                for (int i = i0; i < i1; ++i, p += step)
+                {
+                    // Logical black clears bits; INVERT_BYTES flips that on the wire
+                    bool black = (row[i >> 3] & (0x80u >> (i & 7))) == 0;
+                    if (black == Traits::INVERT_BYTES)
+                        *p |= wm;
+                    else
+                        *p &= (uint8_t)~wm;
+                }
+            }
+        }
+    }
+
+    // Plane column holding glass byte column c (the master copy for the overlap column)
+    const uint8_t *column_(int c) const
+    {
+        return (c < Panel::MASTER_COLS) ? &master[c * Panel::HEIGHT]
+                                        : &slave[(c - Panel::SLAVE_START) * Panel::HEIGHT];
+    }
+
+    // Apply a glass pixel mask to glass byte column c over glass rows [y0, y1), in every plane holding it
+    void apply_column_(int c, int y0, int y1, uint8_t white_mask, bool black)
+    {
+        uint8_t m = Panel::wire_mask(white_mask);
+
+        // Logical black clears bits; INVERT_BYTES flips that on the wire.
+        bool set_bits = (black == Traits::INVERT_BYTES);
+
+        constexpr int step = Panel::Y_INC ? 1 : -1;
+        const int off = Panel::plane_off(y0);
+
+        uint8_t *planes[2] = {
+            (c < Panel::MASTER_COLS) ? &master[c * Panel::HEIGHT + off] : nullptr,
+            (Panel::DUAL && c >= Panel::SLAVE_START) ? &slave[(c - Panel::SLAVE_START) * Panel::HEIGHT + off] : nullptr,
+        };
+        for (uint8_t *p : planes)
+        {
+            if (!p)
+                continue;
+
+            for (int y = y0; y < y1; ++y, p += step)
+            {
+                if (set_bits)
+                    *p |= m;
+                else
+                    *p &= (uint8_t)~m;
+            }
+        }
+    }
+};
@@ -0,0 +1,173 @@
+#pragma once
+
+#include <cstdint>
+
+#include "ssd1683_bits.h"
+
+// Compile-time description of an SSD1683-family panel.
+//
+// A traits type supplies the raw facts about the glass:
+//
+//   struct PanelFoo
+//   {
+//       static constexpr int WIDTH = 792, HEIGHT = 272;      // pixels
+//       static constexpr int MASTER_COLS = 50;               // byte columns on the master
+//       static constexpr int SLAVE_COLS = 50;                // byte columns on the slave (0 = none)
+//       static constexpr int SLAVE_START = 49;               // first byte column on the slave
+//       static constexpr bool INVERT_BYTES = false;          // white/black swapped on the wire
+//       static constexpr bool BIT_REVERSE = false;           // LSB = left pixel on the wire
+//       static constexpr bool BUSY_ACTIVE_HIGH = true;
+//       static constexpr int ROTATION = 0;                   // see SSD1683Rotated
+//       static constexpr bool MIRROR_X = false;
+//   };
+//
+// SSD1683Panel<Traits> adds the derived layout and the wire transform. Everything
+// is constexpr, so each panel gets its own specialized upload kernel: no transform
+// at all when the glass matches the row-major format, a 256-entry LUT otherwise.
+//
+// WIDTH/HEIGHT/BYTES_PER_ROW describe the glass (controller RAM). FRAME_* describe
+// the row-major frames the firmware is fed and draws into, after rotation.
+template <typename Traits>
+struct SSD1683Panel : Traits
+{
+    using Traits::HEIGHT;
+    using Traits::WIDTH;
+
+    static constexpr int BYTES_PER_ROW = (WIDTH + 7) / 8;
+
+    // Frame orientation. 90/270 swap the frame axes; MIRROR_X flips the frame
+    // horizontally before it is rotated.
+    static constexpr int ROTATION = Traits::ROTATION;
+    static constexpr bool MIRROR_X = Traits::MIRROR_X;
+    static constexpr bool TRANSPOSED = (ROTATION == 90 || ROTATION == 270);
+
+    static constexpr int FRAME_WIDTH = TRANSPOSED ? HEIGHT : WIDTH;
+    static constexpr int FRAME_HEIGHT = TRANSPOSED ? WIDTH : HEIGHT;
+    static constexpr int FRAME_BPR = (FRAME_WIDTH + 7) / 8;
+    static constexpr int FRAME_BYTES = FRAME_BPR * FRAME_HEIGHT;
+
+    // Vertical flips are free: the data-entry mode walks RAM rows upward instead of
+    // downward. Horizontal ones cost a column reversal plus bit reversal in the kernel.
+    static constexpr bool Y_INC = (ROTATION == 180 || ROTATION == 270);
+    static constexpr bool X_REVERSE = !TRANSPOSED && ((ROTATION == 180) != MIRROR_X);
+
+    static_assert(ROTATION == 0 || ROTATION == 90 || ROTATION == 180 || ROTATION == 270, "bad ROTATION");
+    static_assert(WIDTH % 8 == 0 || (!X_REVERSE && !TRANSPOSED), "mirrored/rotated frames need whole-byte width");
+
+    static constexpr bool DUAL = Traits::SLAVE_COLS > 0;
+    static constexpr int MASTER_PLANE_BYTES = Traits::MASTER_COLS * HEIGHT;
+    static constexpr int SLAVE_PLANE_BYTES = Traits::SLAVE_COLS * HEIGHT;
+
+    static_assert(Traits::MASTER_COLS <= BYTES_PER_ROW, "master wider than the frame");
+    static_assert(!DUAL || Traits::SLAVE_START + Traits::SLAVE_COLS == BYTES_PER_ROW,
+                  "slave must end at the last byte column");
+    static_assert(!DUAL || Traits::SLAVE_START <= Traits::MASTER_COLS, "gap between master and slave");
+
+    static constexpr bool XFORM_IDENTITY = !Traits::INVERT_BYTES && !Traits::BIT_REVERSE;
+
+    static constexpr uint8_t bitrev8(uint8_t x)
+    {
+        return (uint8_t)ssd1683_bits::rev_each_byte_c(x);
+    }
+
+    // Row-major byte -> wire byte. Also its own inverse.
+    static inline uint8_t xform(uint8_t b)
+    {
+        if constexpr (XFORM_IDENTITY)
+            return b;
+        else
+            return XFORM_LUT.v[b];
+    }
+
+    // Same transform on four packed bytes. EXTRA_REV folds in a horizontal pixel
+    // mirror (bit reversal) at no extra cost when the glass is bit-reversed anyway.
+    template <bool EXTRA_REV = false>
+    static inline uint32_t xform_word(uint32_t w)
+    {
+        if constexpr (EXTRA_REV != (bool)Traits::BIT_REVERSE)
+            w = ssd1683_bits::rev_each_byte(w);
+        if constexpr (Traits::INVERT_BYTES)
+            w = ~w;
+        return w;
+    }
+
+    template <bool EXTRA_REV = false>
+    static inline uint8_t xform_rev(uint8_t b)
+    {
+        return xform(EXTRA_REV ? ssd1683_bits::rev8(b) : b);
+    }
+
+    // Row-major pixel mask (MSB = left) -> wire bit positions
+    static inline uint8_t wire_mask(uint8_t m)
+    {
+        if constexpr (Traits::BIT_REVERSE)
+            return ssd1683_bits::rev8(m);
+        else
+            return m;
+    }
+
+    // Plane byte offset of glass row py inside a plane column
+    static constexpr int plane_off(int py)
+    {
+        return Y_INC ? py : (HEIGHT - 1 - py);
+    }
+
+    // Frame pixel -> glass pixel
+    static constexpr void to_glass(int fx, int fy, int &px, int &py)
+    {
+        if (MIRROR_X)
+            fx = FRAME_WIDTH - 1 - fx;
+
+        switch (ROTATION)
+        {
+        case 90:
+            px = fy;
+            py = HEIGHT - 1 - fx;
+            break;
+        case 180:
+            px = WIDTH - 1 - fx;
+            py = HEIGHT - 1 - fy;
+            break;
+        case 270:
+            px = WIDTH - 1 - fy;
+            py = fx;
+            break;
+        default:
+            px = fx;
+            py = fy;
+            break;
+        }
+    }
+
+private:
+    struct Lut
+    {
+        uint8_t v[256];
+    };
+
+    static constexpr Lut make_lut_()
+    {
+        Lut l{};
+        for (int i = 0; i < 256; ++i)
+        {
+            uint8_t b = (uint8_t)i;
+            if (Traits::BIT_REVERSE)
+                b = bitrev8(b);
+            if (Traits::INVERT_BYTES)
+                b = (uint8_t)~b;
+            l.v[i] = b;
+        }
+        return l;
+    }
+
+    static constexpr Lut XFORM_LUT = make_lut_();
+};
+
+// Mounting adaptor: the same glass, rotated clockwise by ROT degrees and/or mirrored.
+//   using EPDPanel = SSD1683Rotated<PanelGDEY0579T93, 90>; // portrait, 272x792 frames
+template <typename Base, int ROT, bool MIRROR = false>
+struct SSD1683Rotated : Base
+{
+    static constexpr int ROTATION = ROT;
+    static constexpr bool MIRROR_X = MIRROR;
+};
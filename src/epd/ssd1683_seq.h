@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstdint>
+#include <initializer_list>
+
+// Controller command sequences as byte code, so init, window setup and refresh
+// triggers are constexpr tables instead of strings of cmd_()/data_() calls.
+//
+// Each entry starts with an op byte:
+//   0..MAX_DATA   a command: opcode byte, then that many parameter bytes
+//   WAIT_BUSY     wait for BUSY release (the caller's timeout applies)
+//   DELAY_MS      sleep for the next byte's worth of milliseconds
+//   END           end of the sequence
+//
+// The interpreter (SSD1683::run_seq_) sends a command and its parameters in one
+// CS frame, switching DC once in between.
+namespace ssd1683_seq
+{
+    static constexpr uint8_t MAX_DATA = 0x1F;
+    static constexpr uint8_t DELAY_MS = 0xFD;
+    static constexpr uint8_t WAIT_BUSY = 0xFE;
+    static constexpr uint8_t END = 0xFF;
+
+    // Fixed-capacity sequence builder; usable in constant expressions
+    template <int N>
+    struct Seq
+    {
+        uint8_t b[N] = {};
+        int n = 0;
+
+        constexpr Seq &cmd(uint8_t c, std::initializer_list<uint8_t> data = {})
+        {
+            b[n++] = (uint8_t)data.size();
+            b[n++] = c;
+            for (uint8_t d : data)
+                b[n++] = d;
+            return *this;
+        }
+
+        constexpr Seq &wait_busy()
+        {
+            b[n++] = WAIT_BUSY;
+            return *this;
+        }
+
+        constexpr Seq &delay_ms(uint8_t ms)
+        {
+            b[n++] = DELAY_MS;
+            b[n++] = ms;
+            return *this;
+        }
+
+        constexpr Seq &end()
+        {
+            b[n++] = END;
+            return *this;
+        }
+    };
+}
@@ -0,0 +1,206 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+#include "ssd1683_panel.h"
+
+// Row-major frame (top row first, MSB = left pixel, FRAME_* geometry) -> master/slave
+// planes in controller RAM order (see SSD1683NativeFrame for the layout).
+//
+// 0/180 degrees: 4-row x 4-column tiles. Four unaligned 32-bit row loads, a register
+// transpose, then one aligned 32-bit store per output column. A horizontal mirror
+// only changes which column a word is stored to, plus a word-wide bit reversal.
+//
+// 90/270 degrees: 8-row x 1-byte tiles through an 8x8 bit-matrix transpose. The
+// eight output bytes are adjacent in one plane column, so they go out as two word
+// stores when the geometry keeps them aligned.
+//
+// Vertical flips never reach the kernel: the driver picks a Y-increment data-entry
+// mode instead. The panel's wire transform is folded into the same pass (and
+// compiles away when the panel needs none). The source is read once; the overlap
+// column is stored into both planes.
+//
+// Header-only so each panel/orientation gets its own fully specialized kernel.
+// master/slave must be 4-byte aligned; slave is ignored on single-controller panels.
+namespace ssd1683_detail
+{
+    static inline uint32_t load_u32(const uint8_t *p)
+    {
+        uint32_t v;
+        memcpy(&v, p, 4); // single LDR on M33 (unaligned access is allowed)
+        return v;
+    }
+
+    // off = byte offset inside plane column col
+    template <typename P>
+    static inline void store_col(uint8_t *master, uint8_t *slave, int col, int off, uint32_t w)
+    {
+        if (col < P::MASTER_COLS)
+            *(uint32_t *)(master + col * P::HEIGHT + off) = w;
+        if (P::DUAL && col >= P::SLAVE_START)
+            *(uint32_t *)(slave + (col - P::SLAVE_START) * P::HEIGHT + off) = w;
+    }
+
+    template <typename P>
+    static inline void store_byte(uint8_t *master, uint8_t *slave, int col, int off, uint8_t b)
+    {
+        if (col < P::MASTER_COLS)
+            master[col * P::HEIGHT + off] = b;
+        if (P::DUAL && col >= P::SLAVE_START)
+            slave[(col - P::SLAVE_START) * P::HEIGHT + off] = b;
+    }
+
+    // 0 / 180 degrees (optionally mirrored)
+    template <typename P>
+    static void transform_tiled(const uint8_t *frame, uint8_t *master, uint8_t *slave)
+    {
+        constexpr int H = P::HEIGHT;
+        constexpr int BPR = P::BYTES_PER_ROW;
+        constexpr int WIDE_COLS = BPR & ~3; // columns handled by 32-bit loads
+        constexpr bool XREV = P::X_REVERSE;
+
+        // Also keeps every plane column (c * H) word aligned
+        static_assert(H % 4 == 0, "tile kernel needs HEIGHT to be a multiple of 4");
+
+        // Frame row y lands on glass row py with plane_off(py) == H - 1 - y for both
+        // orientations (180 flips py and the Y-increment entry mode flips it back).
+        auto col_of = [](int c)
+        { return XREV ? (BPR - 1 - c) : c; };
+
+        for (int y = 0; y < H; y += 4)
+        {
+            const uint8_t *r0 = frame + (y + 0) * BPR;
+            const uint8_t *r1 = r0 + BPR;
+            const uint8_t *r2 = r1 + BPR;
+            const uint8_t *r3 = r2 + BPR;
+
+            // Rows y..y+3 land at plane offsets (H-1-y)..(H-4-y); as a little-endian
+            // word that is [r3, r2, r1, r0] from low byte to high byte.
+            int off = H - 4 - y;
+
+            for (int c = 0; c < WIDE_COLS; c += 4)
+            {
+                uint32_t w0 = load_u32(r0 + c);
+                uint32_t w1 = load_u32(r1 + c);
+                uint32_t w2 = load_u32(r2 + c);
+                uint32_t w3 = load_u32(r3 + c);
+
+                // 4x4 byte transpose in two butterfly stages
+                uint32_t a = (w3 & 0x00FF00FFu) | ((w2 & 0x00FF00FFu) << 8); // cols 0,2 of rows 3,2
+                uint32_t b = ((w3 >> 8) & 0x00FF00FFu) | (w2 & 0xFF00FF00u); // cols 1,3 of rows 3,2
+                uint32_t p = (w1 & 0x00FF00FFu) | ((w0 & 0x00FF00FFu) << 8); // cols 0,2 of rows 1,0
+                uint32_t q = ((w1 >> 8) & 0x00FF00FFu) | (w0 & 0xFF00FF00u); // cols 1,3 of rows 1,0
+
+                store_col<P>(master, slave, col_of(c + 0), off, P::template xform_word<XREV>((a & 0xFFFFu) | (p << 16)));
+                store_col<P>(master, slave, col_of(c + 1), off, P::template xform_word<XREV>((b & 0xFFFFu) | (q << 16)));
+                store_col<P>(master, slave, col_of(c + 2), off, P::template xform_word<XREV>((a >> 16) | (p & 0xFFFF0000u)));
+                store_col<P>(master, slave, col_of(c + 3), off, P::template xform_word<XREV>((b >> 16) | (q & 0xFFFF0000u)));
+            }
+
+            // Remaining columns when the row is not a multiple of 4 bytes
+            for (int c = WIDE_COLS; c < BPR; ++c)
+            {
+                int col = col_of(c);
+                store_byte<P>(master, slave, col, off + 0, P::template xform_rev<XREV>(r3[c]));
+                store_byte<P>(master, slave, col, off + 1, P::template xform_rev<XREV>(r2[c]));
+                store_byte<P>(master, slave, col, off + 2, P::template xform_rev<XREV>(r1[c]));
+                store_byte<P>(master, slave, col, off + 3, P::template xform_rev<XREV>(r0[c]));
+            }
+        }
+    }
+
+    // 8x8 bit-matrix transpose (Hacker's Delight 7-3). In: x/y = rows 0-3 / 4-7,
+    // row 0 in the top byte. Out: same packing, byte j = column j (MSB = row 0).
+    static inline void transpose8(uint32_t &x, uint32_t &y)
+    {
+        uint32_t t;
+        t = (x ^ (x >> 7)) & 0x00AA00AAu;
+        x = x ^ t ^ (t << 7);
+        t = (y ^ (y >> 7)) & 0x00AA00AAu;
+        y = y ^ t ^ (t << 7);
+
+        t = (x ^ (x >> 14)) & 0x0000CCCCu;
+        x = x ^ t ^ (t << 14);
+        t = (y ^ (y >> 14)) & 0x0000CCCCu;
+        y = y ^ t ^ (t << 14);
+
+        t = (x & 0xF0F0F0F0u) | ((y >> 4) & 0x0F0F0F0Fu);
+        y = ((x << 4) & 0xF0F0F0F0u) | (y & 0x0F0F0F0Fu);
+        x = t;
+    }
+
+    // 90 / 270 degrees (optionally mirrored)
+    template <typename P>
+    static void transform_transposed(const uint8_t *frame, uint8_t *master, uint8_t *slave)
+    {
+        constexpr int H = P::HEIGHT;
+        constexpr int BPR = P::BYTES_PER_ROW;
+        constexpr int FW = P::FRAME_WIDTH; // == H
+        constexpr int FBPR = P::FRAME_BPR;
+
+        // Frame rows 8b..8b+7 form glass byte column b (reversed at 270, which also
+        // reverses the bit order inside each byte).
+        constexpr bool REV270 = (P::ROTATION == 270);
+
+        // Frame column fx sits at plane offset fx (mirrored: FW - 1 - fx) in either
+        // orientation; the entry mode takes care of the direction.
+        constexpr bool MIRROR = P::MIRROR_X;
+        constexpr bool WORDS = (FW % 8 == 0) && (H % 4 == 0);
+
+        for (int b = 0; b < BPR; ++b)
+        {
+            int col = REV270 ? (BPR - 1 - b) : b;
+            const uint8_t *rows = frame + (8 * b) * FBPR;
+
+            for (int fc = 0; fc < FBPR; ++fc)
+            {
+                const uint8_t *s = rows + fc;
+                uint32_t x = ((uint32_t)s[0 * FBPR] << 24) | ((uint32_t)s[1 * FBPR] << 16) |
+                             ((uint32_t)s[2 * FBPR] << 8) | (uint32_t)s[3 * FBPR];
+                uint32_t y = ((uint32_t)s[4 * FBPR] << 24) | ((uint32_t)s[5 * FBPR] << 16) |
+                             ((uint32_t)s[6 * FBPR] << 8) | (uint32_t)s[7 * FBPR];
+                transpose8(x, y);
+
+                // x = [B0 B1 B2 B3] from the top byte down, y = [B4 .. B7]; Bj is frame column 8fc+j
+                if constexpr (WORDS)
+                {
+                    if (MIRROR)
+                    {
+                        int off = FW - 8 - 8 * fc; // B7 first
+                        store_col<P>(master, slave, col, off + 0, P::template xform_word<REV270>(y));
+                        store_col<P>(master, slave, col, off + 4, P::template xform_word<REV270>(x));
+                    }
+                    else
+                    {
+                        int off = 8 * fc; // B0 first
+                        store_col<P>(master, slave, col, off + 0, P::template xform_word<REV270>(__builtin_bswap32(x)));
+                        store_col<P>(master, slave, col, off + 4, P::template xform_word<REV270>(__builtin_bswap32(y)));
+                    }
+                }
+                else
+                {
+                    for (int j = 0; j < 8; ++j)
+                    {
+                        int fx = 8 * fc + j;
+                        if (fx >= FW)
+                            break;
+                        uint8_t v = (uint8_t)((j < 4 ? x : y) >> (24 - 8 * (j & 3)));
+                        store_byte<P>(master, slave, col, MIRROR ? (FW - 1 - fx) : fx, P::template xform_rev<REV270>(v));
+                    }
+                }
+            }
+        }
+    }
+}
+
+template <typename Traits>
+void ssd1683_transform_rowmajor(const uint8_t *frame, uint8_t *master, uint8_t *slave)
+{
+    using P = SSD1683Panel<Traits>;
+
+    if constexpr (P::TRANSPOSED)
+        ssd1683_detail::transform_transposed<P>(frame, master, slave);
+    else
+        ssd1683_detail::transform_tiled<P>(frame, master, slave);
+}
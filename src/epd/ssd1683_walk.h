@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstdint>
+
+#if MINDWRITE_INTERP
+#include "hardware/interp.h"
+#endif
+
+// Index arithmetic for the blit kernel (SSD1683NativeFrame::blit_row_major).
+//
+// A walk visits consecutive glass byte columns in one row, yielding the offset of
+// each one's byte (stride = plane column height), and cuts the source byte out of a
+// 16-bit window of the source row (fixed bit alignment per blit). Two interchangeable
+// implementations:
+//
+//   PlainWalk   shifts and adds on the core
+//   InterpWalk  the same sums on the calling core's INTERP0: lane 0 shifts/masks the
+//               window, lane 1 steps the offset on every pop
+//
+// SSD1683BlitWalk is the one picked at build time (MINDWRITE_INTERP); both are
+// available to kernel_bench for comparison.
+struct PlainWalk
+{
+    PlainWalk(int shift, int stride) : shift_(shift), stride_(stride) {}
+
+    void row(int first) { o_ = first; }
+
+    // Source byte for the next column; o = its byte offset
+    uint8_t next(uint32_t window, int &o)
+    {
+        o = o_;
+        o_ += stride_;
+        return (uint8_t)(window >> shift_);
+    }
+
+private:
+    int shift_;
+    int stride_;
+    int o_ = 0;
+};
+
+#if MINDWRITE_INTERP
+// Owns INTERP0 of the calling core while alive (nothing else in the firmware uses
+// it, and no IRQ handler does)
+struct InterpWalk
+{
+    InterpWalk(int shift, int stride)
+    {
+        interp_config c = interp_default_config();
+        interp_config_set_shift(&c, (uint)shift);
+        interp_config_set_mask(&c, 0, 7);
+        interp_set_config(interp0, 0, &c);
+
+        c = interp_default_config(); // lane 1: BASE1 + ACCUM1, written back on pop
+        interp_set_config(interp0, 1, &c);
+
+        interp0->base[0] = 0;
+        interp0->base[1] = (uint32_t)stride;
+    }
+
+    void row(int first) { interp0->accum[1] = (uint32_t)first; }
+
+    uint8_t next(uint32_t window, int &o)
+    {
+        interp0->accum[0] = window;
+        o = (int)interp0->accum[1];
+        return (uint8_t)interp0->pop[0]; // also advances ACCUM1 by the stride
+    }
+};
+
+using SSD1683BlitWalk = InterpWalk;
+#else
+using SSD1683BlitWalk = PlainWalk;
+#endif
@@ -0,0 +1,68 @@
+#include "executor.h"
+
+#include "hardware/sync.h"
+
+int Executor::add(TaskFn fn, void *ctx)
+{
+    if (count_ >= MAX_TASKS)
+        return -1;
+
+    tasks_[count_].fn = fn;
+    tasks_[count_].ctx = ctx;
+    return count_++;
+}
+
+void Executor::post(int id)
+{
+    __atomic_fetch_or(&ready_, 1u << id, __ATOMIC_RELAXED);
+    __sev(); // wake run() if it is parked in WFE
+}
+
+void Executor::post_at(int id, absolute_time_t t)
+{
+    tasks_[id].due = t;
+    tasks_[id].timed = true;
+}
+
+bool Executor::run_once()
+{
+    uint32_t ready = __atomic_exchange_n(&ready_, 0u, __ATOMIC_RELAXED);
+
+    absolute_time_t now = get_absolute_time();
+    for (int i = 0; i < count_; ++i)
+    {
+        if (tasks_[i].timed && absolute_time_diff_us(now, tasks_[i].due) <= 0)
+        {
+            tasks_[i].timed = false;
+            ready |= 1u << i;
+        }
+    }
+
+    if (!ready)
+        return false;
+
+    for (int i = 0; i < count_; ++i)
+    {
+        if (ready & (1u << i))
+            tasks_[i].fn(tasks_[i].ctx);
+    }
+    return true;
+}
+
+void Executor::run()
+{
+    while (true)
+    {
+        if (run_once())
+            continue;
+
+        // Sleep until an IRQ posts something or the earliest timer is due
+        absolute_time_t wake = at_the_end_of_time;
+        for (int i = 0; i < count_; ++i)
+        {
+            if (tasks_[i].timed && absolute_time_diff_us(tasks_[i].due, wake) > 0)
+                wake = tasks_[i].due;
+        }
+        best_effort_wfe_or_timeout(wake);
+    }
+}
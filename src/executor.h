@@ -0,0 +1,50 @@
+#pragma once
+#include <cstdint>
+
+#include "pico/stdlib.h"
+
+// Minimal cooperative executor for the firmware main loop.
+//
+// Tasks are plain callbacks that do a bounded amount of work and return. A task
+// runs when it has been posted (from anywhere, including IRQ handlers) or when its
+// timer expires. With nothing to do the core sleeps in WFE until an IRQ posts
+// work or the earliest timer is due, so the hot path never calls sleep_ms().
+class Executor
+{
+public:
+    static constexpr int MAX_TASKS = 16;
+
+    using TaskFn = void (*)(void *ctx);
+
+    // Register a task; returns its id (or -1 when full). Call before run().
+    int add(TaskFn fn, void *ctx = nullptr);
+
+    // Mark a task ready. Safe from IRQ handlers.
+    void post(int id);
+
+    // Run a task once at (or soon after) t; replaces any earlier timer for it.
+    // Main-loop only.
+    void post_at(int id, absolute_time_t t);
+    void post_in_ms(int id, uint32_t ms) { post_at(id, make_timeout_time_ms(ms)); }
+
+    // Run every ready/expired task once; returns false if there was nothing to do.
+    bool run_once();
+
+    // Never returns.
+    [[noreturn]] void run();
+
+private:
+    struct Task
+    {
+        TaskFn fn = nullptr;
+        void *ctx = nullptr;
+        absolute_time_t due = 0;
+        bool timed = false;
+    };
+
+    Task tasks_[MAX_TASKS];
+    int count_ = 0;
+
+    // Bit i = task i posted (set from IRQs, drained by run_once)
+    volatile uint32_t ready_ = 0;
+};
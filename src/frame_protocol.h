@@ -31,3 +31,99 @@ struct MPFBHeader
 #pragma pack(pop)
 
 static constexpr uint8_t MPFB_FLAG_FORCE_FULL = 0x02;
+
+// Stream protocol spoken by mindwrite_epd_stream (PC -> Pico), all integers little-endian:
+//
+//   "MWF1" len:u32 payload[len] crc32:u32            full frame for panel 0
+//   "MWP1" panel:u8 len:u32 payload[len] crc32:u32   full frame for panel N (multi-panel builds)
+//   "MWR1" panel:u8 len:u32 payload[len] crc32:u32   rectangle update (see below)
+//   "MWC1" panel:u8 len:u32 payload[len] crc32:u32   control message, len <= MW_CONTROL_MAX
+//   "MWZ1" panel:u8 len:u32 payload[len] crc32:u32   full frame, compressed in row bands
+//   "MWD1" panel:u8 len:u32 payload[len] crc32:u32   rects on top of a cached reference frame
+//   "MWM1" panel:u8 len:u32 payload[len] crc32:u32   move a region of the frame, then draw rects
+//
+// payload = packed 1bpp frame in the panel's mounted orientation (row-major, MSB = left).
+// The ACK (Pico -> PC) is sent once the frame has been queued for its panel, so the
+// host can stream the next frame while a refresh is still running. Frames that arrive
+// faster than the panel refreshes are coalesced: only the newest one is shown.
+//
+//   'O','K'          after MWF1
+//   'O','K',panel    after MWP1, MWR1, MWZ1, MWD1, MWM1 and accepted MWC1
+//   'E','R',code     bad length (0x01), bad CRC (0x02), bad control/rect/delta/move message (0x03),
+//                    MWZ1 band table or band data that does not decode (0x04),
+//                    MWD1 reference slot that holds no frame (0x05)
+//
+// A link that enabled MW_CTL_TIMING gets instead, after MWF1/MWP1/MWR1/MWZ1/MWD1/MWM1:
+//
+//   'O','K',panel,eta_ms:u16,refresh_ms:u16
+//       eta_ms: predicted time until this update is on the glass (coalescing wait,
+//       the running refresh, upload and refresh). refresh_ms: predicted BUSY time
+//       of one refresh. Both saturate at 0xFFFF.
+//
+// and, unsolicited, whenever a panel finishes a refresh:
+//
+//   'R','D',panel,busy_ms:u16,eta_ms:u16
+//       measured BUSY time, and eta_ms of the damage still pending (0 = none).
+//
+// Rect payload = lane:u8 x:u16 y:u16 w:u16 h:u16 pixels[((w + 7) / 8) * h]
+//   Pixels are row-major 1bpp like a frame, in frame coordinates. lane 1
+//   (interactive: caret, typed glyph) refreshes as soon as the panel is idle and
+//   preempts background uploads between slices; lane 0 behaves like a frame.
+//
+// Banded payload = band_rows:u16 band_count:u16 {len:u32 crc32:u32}[band_count] data...
+//   Band i holds frame rows [i * band_rows, (i + 1) * band_rows) (the last one may be
+//   shorter; band_count must cover the frame exactly). Each band is one LZ4 block (no
+//   frame header, no match reaching outside the band) and the blocks are stored back
+//   to back, so bands decode independently: the firmware runs them on both cores,
+//   straight into their rows of the frame. crc32 covers the band's decoded bytes.
+//   len is capped like a full-frame rect; send MWF1 when compression does not win.
+//
+// Delta payload = ref:u8 store:u8 lane:u8 count:u8 {x:u16 y:u16 w:u16 h:u16 pixels}[count]
+//   The panel's pending frame becomes reference slot ref (MW_DELTA_CURRENT keeps the
+//   pending frame as it is), then the count rects are drawn on it like MWR1 rects.
+//   With store != MW_DELTA_NONE the result is also cached in slot store. The slots
+//   (MINDWRITE_REF_SLOTS, shared by all panels) are managed by the host, typically
+//   one per screen the UI switches between, so going back to a screen costs only
+//   what changed on it. count = 0 is fine: ref = k recalls a screen as it was
+//   stored, ref = CURRENT with store = k snapshots the pending frame. Slots are empty
+//   after boot; ER 0x05 means "resend a full frame, then store it".
+//
+// Move payload = lane:u8 x:u16 y:u16 w:u16 h:u16 dx:i16 dy:i16 {x y w h pixels}...
+//   Copies frame rect (x, y, w, h) to (x + dx, y + dy), any pixel offset, clipped
+//   to the frame; overlap is handled. Uncovered pixels keep their value. Then the
+//   trailing rects (MWD1 rect format, as many as fill the payload, possibly none)
+//   are drawn. Inserting a character mid-line is one message: shift the rest of the
+//   line right by the glyph's advance, draw the glyph.
+//
+// Control payload = op:u8 args... (panel 0xFF = every panel):
+//
+//   MW_CTL_REFRESH_POLICY  deadline_ms:u16 quiet_ms:u16 big_area_pct:u8 trace:u8
+//       Refresh coalescing (see RefreshScheduler). deadline_ms = 0 refreshes as soon
+//       as the panel is idle. trace = 1 prints one line per scheduler decision.
+//
+//   MW_CTL_TIMING  enable:u8
+//       Timing ACKs and refresh-done events on this link (see above). Off by default.
+
+static constexpr uint8_t MW_MAGIC_FRAME[4] = {'M', 'W', 'F', '1'};
+static constexpr uint8_t MW_MAGIC_PANEL_FRAME[4] = {'M', 'W', 'P', '1'};
+static constexpr uint8_t MW_MAGIC_RECT[4] = {'M', 'W', 'R', '1'};
+static constexpr uint8_t MW_MAGIC_CONTROL[4] = {'M', 'W', 'C', '1'};
+static constexpr uint8_t MW_MAGIC_BANDS[4] = {'M', 'W', 'Z', '1'};
+static constexpr uint8_t MW_MAGIC_DELTA[4] = {'M', 'W', 'D', '1'};
+static constexpr uint8_t MW_MAGIC_MOVE[4] = {'M', 'W', 'M', '1'};
+
+static constexpr uint32_t MW_RECT_HEADER = 9;
+static constexpr uint32_t MW_BANDS_HEADER = 4;
+static constexpr uint32_t MW_BANDS_ENTRY = 8;
+static constexpr int MW_BANDS_MAX = 64;
+static constexpr uint32_t MW_DELTA_HEADER = 4;
+static constexpr uint32_t MW_DELTA_RECT = 8;
+static constexpr uint8_t MW_DELTA_CURRENT = 0xFF;
+static constexpr uint8_t MW_DELTA_NONE = 0xFF;
+static constexpr uint32_t MW_MOVE_HEADER = 13;
+
+static constexpr uint32_t MW_CONTROL_MAX = 64;
+static constexpr uint8_t MW_CONTROL_ALL_PANELS = 0xFF;
+
+static constexpr uint8_t MW_CTL_REFRESH_POLICY = 0x01;
+static constexpr uint8_t MW_CTL_TIMING = 0x02;
@@ -0,0 +1,237 @@
+#include "frame_receiver.h"
+#include <cstring>
+#include "pico/stdlib.h"
+
+#include "crc32.h"
+#include "frame_protocol.h"
+#include "sram_placement.h"
+
+FrameReceiver::FrameReceiver(Transport &link, uint32_t expected_len, uint8_t *buf)
+    : link_(link), expected_len_(expected_len), buf_(buf)
+{
+    state_ = State::MAGIC;
+}
+
+bool MW_RAM_CODE("frame_receiver") FrameReceiver::poll(FrameMessage &out, uint32_t max_bytes)
+{
+    drained_ = false;
+    while (max_bytes > 0)
+    {
+        if (state_ == State::PAYLOAD)
+        {
+            // Bulk run: transport -> message buffer, CRC over what landed
+            uint32_t want = frame_len_ - payload_pos_;
+            if (want > max_bytes)
+                want = max_bytes;
+
+            uint8_t *dst = buf_ + payload_pos_;
+            uint32_t n = (uint32_t)link_.read(dst, want);
+            if (n == 0)
+            {
+                drained_ = true;
+                return false; // nothing available
+            }
+
+            crc_calc_ = crc32_update(crc_calc_, dst, n);
+            payload_pos_ += n;
+            bytes_in_ += n;
+            max_bytes -= n;
+
+            if (payload_pos_ == frame_len_)
+            {
+                state_ = State::CRC;
+                crc_pos_ = 0;
+            }
+            continue;
+        }
+
+        size_t avail;
+        const uint8_t *p = link_.peek(avail);
+        if (avail == 0)
+        {
+            drained_ = true;
+            return false; // nothing available
+        }
+        if (avail > max_bytes)
+            avail = max_bytes;
+
+        // Header bytes in place, up to the payload or the end of a message
+        size_t used = 0;
+        bool done = false;
+        while (used < avail && state_ != State::PAYLOAD && !done)
+            done = header_byte_(p[used++], out);
+
+        link_.consume(used);
+        bytes_in_ += (uint32_t)used;
+        max_bytes -= (uint32_t)used;
+        if (done)
+            return true;
+    }
+    return false; // budget used up; more may be waiting
+}
+
+bool MW_RAM_CODE("frame_receiver") FrameReceiver::header_byte_(uint8_t b, FrameMessage &out)
+{
+    switch (state_)
+    {
+    case State::MAGIC:
+        magic_[magic_pos_++] = b;
+        if (magic_pos_ == 4)
+        {
+            kind_ = FrameMessage::Kind::FRAME;
+            if (memcmp(magic_, MW_MAGIC_FRAME, 4) == 0)
+            {
+                panel_ = -1;
+                state_ = State::LEN;
+                len_pos_ = 0;
+            }
+            else if (memcmp(magic_, MW_MAGIC_PANEL_FRAME, 4) == 0)
+            {
+                state_ = State::PANEL;
+            }
+            else if (memcmp(magic_, MW_MAGIC_RECT, 4) == 0)
+            {
+                kind_ = FrameMessage::Kind::RECT;
+                state_ = State::PANEL;
+            }
+            else if (memcmp(magic_, MW_MAGIC_CONTROL, 4) == 0)
+            {
+                kind_ = FrameMessage::Kind::CONTROL;
+                state_ = State::PANEL;
+            }
+            else if (memcmp(magic_, MW_MAGIC_BANDS, 4) == 0)
+            {
+                kind_ = FrameMessage::Kind::BANDS;
+                state_ = State::PANEL;
+            }
+            else if (memcmp(magic_, MW_MAGIC_DELTA, 4) == 0)
+            {
+                kind_ = FrameMessage::Kind::DELTA;
+                state_ = State::PANEL;
+            }
+            else if (memcmp(magic_, MW_MAGIC_MOVE, 4) == 0)
+            {
+                kind_ = FrameMessage::Kind::MOVE;
+                state_ = State::PANEL;
+            }
+            else
+            {
+                // shift window by 1 and keep searching
+                magic_[0] = magic_[1];
+                magic_[1] = magic_[2];
+                magic_[2] = magic_[3];
+                magic_pos_ = 3;
+            }
+        }
+        break;
+
+    case State::PANEL:
+        panel_ = b;
+        state_ = State::LEN;
+        len_pos_ = 0;
+        break;
+
+    case State::LEN:
+        len_bytes_[len_pos_++] = b;
+        if (len_pos_ == 4)
+        {
+            frame_len_ = (uint32_t)len_bytes_[0] | ((uint32_t)len_bytes_[1] << 8) | ((uint32_t)len_bytes_[2] << 16) | ((uint32_t)len_bytes_[3] << 24);
+
+            bool len_ok;
+            switch (kind_)
+            {
+            case FrameMessage::Kind::RECT:
+                len_ok = frame_len_ > MW_RECT_HEADER && frame_len_ <= expected_len_ + MW_RECT_HEADER;
+                break;
+            case FrameMessage::Kind::CONTROL:
+                len_ok = frame_len_ >= 1 && frame_len_ <= MW_CONTROL_MAX;
+                break;
+            case FrameMessage::Kind::BANDS:
+                len_ok = frame_len_ > MW_BANDS_HEADER && frame_len_ <= expected_len_ + MW_RECT_HEADER;
+                break;
+            case FrameMessage::Kind::DELTA:
+                len_ok = frame_len_ >= MW_DELTA_HEADER && frame_len_ <= expected_len_ + MW_RECT_HEADER;
+                break;
+            case FrameMessage::Kind::MOVE:
+                len_ok = frame_len_ >= MW_MOVE_HEADER && frame_len_ <= expected_len_ + MW_RECT_HEADER;
+                break;
+            default:
+                len_ok = frame_len_ == expected_len_;
+                break;
+            }
+            if (!len_ok)
+            {
+                send_ack_err(0x01); // bad len
+                resync();
+                break;
+            }
+
+            payload_pos_ = 0;
+            crc_calc_ = CRC32_INIT;
+            state_ = State::PAYLOAD;
+        }
+        break;
+
+    case State::CRC:
+        crc_bytes_[crc_pos_++] = b;
+        if (crc_pos_ == 4)
+        {
+            uint32_t crc_rx = (uint32_t)crc_bytes_[0] | ((uint32_t)crc_bytes_[1] << 8) | ((uint32_t)crc_bytes_[2] << 16) | ((uint32_t)crc_bytes_[3] << 24);
+
+            // Prepare for next message either way
+            resync();
+
+            if (~crc_calc_ != crc_rx)
+            {
+                send_ack_err(0x02); // bad crc
+                break;
+            }
+
+            out.payload = buf_;
+            out.payload_len = frame_len_;
+            out.panel = panel_;
+            out.kind = kind_;
+            return true;
+        }
+        break;
+
+    case State::PAYLOAD:
+        break; // handled in bulk by poll()
+    }
+    return false;
+}
+
+void FrameReceiver::resync()
+{
+    state_ = State::MAGIC;
+    magic_pos_ = 0;
+}
+
+void FrameReceiver::send_ack_ok(int panel)
+{
+    // binary-safe 2-byte ACK (+ panel index for MWP1)
+    uint8_t ack[3] = {'O', 'K', (uint8_t)panel};
+    link_.write(ack, panel >= 0 ? 3 : 2);
+}
+
+void FrameReceiver::send_ack_eta(uint8_t panel, uint16_t eta_ms, uint16_t refresh_ms)
+{
+    uint8_t ack[7] = {'O', 'K', panel,
+                      (uint8_t)eta_ms, (uint8_t)(eta_ms >> 8),
+                      (uint8_t)refresh_ms, (uint8_t)(refresh_ms >> 8)};
+    link_.write(ack, sizeof(ack));
+}
+
+void FrameReceiver::send_refresh_done(uint8_t panel, uint16_t busy_ms, uint16_t eta_ms)
+{
+    uint8_t ev[7] = {'R', 'D', panel,
+                     (uint8_t)busy_ms, (uint8_t)(busy_ms >> 8),
+                     (uint8_t)eta_ms, (uint8_t)(eta_ms >> 8)};
+    link_.write(ev, sizeof(ev));
+}
+
+void FrameReceiver::send_ack_err(uint8_t code)
+{
+    uint8_t nak[3] = {'E', 'R', code};
+    link_.write(nak, 3);
+}
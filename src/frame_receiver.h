@@ -0,0 +1,96 @@
+#pragma once
+#include <cstdint>
+
+#include "transport.h"
+
+// One validated message of the stream protocol (frame_protocol.h)
+struct FrameMessage
+{
+    enum class Kind : uint8_t
+    {
+        FRAME,   // MWF1 / MWP1
+        RECT,    // MWR1
+        CONTROL, // MWC1
+        BANDS,   // MWZ1
+        DELTA,   // MWD1
+        MOVE,    // MWM1
+    };
+
+    const uint8_t *payload = nullptr;
+    uint32_t payload_len = 0;
+    int panel = -1; // panel index, -1 for MWF1
+    Kind kind = Kind::FRAME;
+};
+
+// Stream protocol parser, fed by any Transport.
+//
+// Header bytes are parsed in place from the transport's chunks; payloads are
+// copied once, straight from the transport into the message buffer, with the
+// CRC computed over each run as it lands.
+class FrameReceiver
+{
+public:
+    // buf holds one message: expected_len + MW_RECT_HEADER bytes (the largest message
+    // is a full-frame rect), owned by the caller
+    FrameReceiver(Transport &link, uint32_t expected_len, uint8_t *buf);
+
+    Transport &link() { return link_; }
+
+    // Non-blocking; returns true when a full validated message is ready in out.
+    // Consumes at most max_bytes so it can share the core with other tasks.
+    // out.payload stays valid until the next call.
+    bool poll(FrameMessage &out, uint32_t max_bytes = 4096);
+
+    // True when the last poll() stopped because no input was left (not on its budget)
+    bool drained() const { return drained_; }
+
+    // For stall detection: inside a message, and total bytes consumed so far
+    bool mid_message() const { return state_ != State::MAGIC || magic_pos_ > 0; }
+    uint32_t bytes_in() const { return bytes_in_; }
+
+    // Drop a partially received message and hunt for the next magic
+    void resync();
+
+    void send_ack_ok(int panel = -1);
+    void send_ack_err(uint8_t code);
+
+    // Timing replies for links that asked for them (MW_CTL_TIMING)
+    void send_ack_eta(uint8_t panel, uint16_t eta_ms, uint16_t refresh_ms);
+    void send_refresh_done(uint8_t panel, uint16_t busy_ms, uint16_t eta_ms);
+
+private:
+    enum class State : uint8_t
+    {
+        MAGIC,
+        PANEL,
+        LEN,
+        PAYLOAD,
+        CRC
+    };
+
+    Transport &link_;
+    uint32_t expected_len_;
+    State state_ = State::MAGIC;
+
+    uint8_t magic_[4]{};
+    uint32_t magic_pos_ = 0;
+    int panel_ = -1;
+    FrameMessage::Kind kind_ = FrameMessage::Kind::FRAME;
+    bool drained_ = false;
+    uint32_t bytes_in_ = 0;
+
+    uint8_t len_bytes_[4]{};
+    uint32_t len_pos_ = 0;
+    uint32_t frame_len_ = 0;
+
+    uint32_t payload_pos_ = 0;
+    uint8_t crc_bytes_[4]{};
+    uint32_t crc_pos_ = 0;
+    uint32_t crc_calc_ = 0;
+
+    // buffer storage
+    uint8_t *buf_;
+
+    // One header byte; true when a complete message is ready in out
+    bool header_byte_(uint8_t b, FrameMessage &out);
+};
@@ -0,0 +1,543 @@
+#include "kernel_bench.h"
+
+#include <cstdio>
+#include <cstring>
+#include <cstdint>
+#include <new>
+
+#include "pico/stdlib.h"
+#include "hardware/xip_cache.h"
+
+#include "band_decoder.h"
+#include "crc32.h"
+#include "epd/ssd1683_bits.h"
+#include "epd/ssd1683_gdey0579t93.h"
+#include "epd/ssd1683_native_frame.h"
+#include "epd/ssd1683_transform.h"
+#include "frame_protocol.h"
+#include "frame_receiver.h"
+#include "memory_transport.h"
+#include "sram_placement.h"
+
+using Panel = SSD1683_GDEY0579T93;
+
+static constexpr int ITERS = 20;
+
+alignas(4) static uint8_t src_frame[Panel::FRAME_BYTES];
+alignas(4) static uint8_t out_master[Panel::MASTER_PLANE_BYTES];
+alignas(4) static uint8_t out_slave[Panel::SLAVE_PLANE_BYTES];
+
+// The original show_full_fullscreen() walk: byte loads with a 99-byte stride, once per plane
+static void transform_bytewise(const uint8_t *frame, uint8_t *master, uint8_t *slave)
+{
+    constexpr int H = Panel::HEIGHT;
+    constexpr int BPR = Panel::BYTES_PER_ROW;
+
+    for (int col = 0; col < Panel::MASTER_COLS; ++col)
+        for (int y = 0; y < H; ++y)
+            *master++ = frame[(H - 1 - y) * BPR + col];
+
+    for (int col = Panel::SLAVE_START; col < Panel::SLAVE_START + Panel::SLAVE_COLS; ++col)
+        for (int y = 0; y < H; ++y)
+            *slave++ = frame[(H - 1 - y) * BPR + col];
+}
+
+// One MWF1 message around src_frame, as it would arrive on a link
+static uint8_t packet[4 + 4 + Panel::FRAME_BYTES + 4];
+
+static void build_packet()
+{
+    uint32_t len = Panel::FRAME_BYTES;
+    uint32_t crc = crc32_compute(src_frame, len);
+
+    memcpy(packet, MW_MAGIC_FRAME, 4);
+    memcpy(packet + 4, &len, 4);
+    memcpy(packet + 8, src_frame, len);
+    memcpy(packet + 8 + len, &crc, 4);
+}
+
+// Glyph-sized blits (a 20x32 cell at an odd x), ten per call
+static SSD1683NativeFrame<PanelGDEY0579T93> blit_frame;
+
+template <typename Walk>
+static void blit_glyphs()
+{
+    for (int g = 0; g < 10; ++g)
+        blit_frame.blit_row_major<Walk>(3 + 21 * g, 40, 20, 32, src_frame, 3);
+}
+
+// The original per-pixel blit, for reference
+static void blit_glyphs_pixels()
+{
+    for (int g = 0; g < 10; ++g)
+        for (int j = 0; j < 32; ++j)
+            for (int i = 0; i < 20; ++i)
+                blit_frame.set_pixel(3 + 21 * g + i, 40 + j, (src_frame[j * 3 + (i >> 3)] & (0x80u >> (i & 7))) == 0);
+}
+
+// Inserting a character mid-line: shift the rest of a 32-row text line right by a
+// glyph advance (MWM1), against redrawing the same area from row-major source
+static void copy_line()
+{
+    blit_frame.copy_rect(100, 40, 500, 32, 5, 0);
+}
+
+static void redraw_line()
+{
+    blit_frame.blit_row_major(105, 40, 500, 32, src_frame, Panel::FRAME_BPR);
+}
+
+// MWZ1 payload of src_frame in 16-row bands, each stored as a literal-only LZ4
+// block (the pattern does not compress); decode cost is then copy + CRC per band
+static constexpr int BAND_ROWS = 16;
+static constexpr int BANDS = (Panel::FRAME_HEIGHT + BAND_ROWS - 1) / BAND_ROWS;
+static uint8_t bands[MW_BANDS_HEADER + BANDS * MW_BANDS_ENTRY + Panel::FRAME_BYTES + BANDS * 128];
+static uint32_t bands_len;
+alignas(4) static uint8_t band_out[Panel::FRAME_BYTES];
+
+static void build_bands()
+{
+    uint8_t *p = bands;
+    *p++ = BAND_ROWS;
+    *p++ = 0;
+    *p++ = BANDS;
+    *p++ = 0;
+    uint8_t *table = p;
+    p += BANDS * MW_BANDS_ENTRY;
+
+    for (int b = 0; b < BANDS; ++b)
+    {
+        int rows = Panel::FRAME_HEIGHT - b * BAND_ROWS;
+        uint32_t n = (uint32_t)(rows < BAND_ROWS ? rows : BAND_ROWS) * Panel::FRAME_BPR;
+        const uint8_t *src = src_frame + b * BAND_ROWS * Panel::FRAME_BPR;
+
+        uint8_t *start = p;
+        *p++ = 0xF0;
+        for (uint32_t v = n - 15;; v -= 255)
+        {
+            *p++ = (uint8_t)(v < 255 ? v : 255);
+            if (v < 255)
+                break;
+        }
+        memcpy(p, src, n);
+        p += n;
+
+        uint32_t len = (uint32_t)(p - start), crc = crc32_compute(src, n);
+        memcpy(table + b * MW_BANDS_ENTRY, &len, 4);
+        memcpy(table + b * MW_BANDS_ENTRY + 4, &crc, 4);
+    }
+    bands_len = (uint32_t)(p - bands);
+}
+
+// 1bpp kernels: a byte-at-a-time reference next to each ssd1683_bits kernel.
+// diff_master is out_master with a few bytes flipped in every 8th column.
+alignas(4) static uint8_t diff_master[Panel::MASTER_PLANE_BYTES];
+static uint8_t shift_out[Panel::FRAME_BPR];
+static uint32_t dirty_bits[4];
+static volatile uint32_t sink;
+
+static void build_diff()
+{
+    memcpy(diff_master, out_master, sizeof(diff_master));
+    for (int c = 0; c < Panel::MASTER_COLS; c += 8)
+    {
+        diff_master[c * Panel::HEIGHT + 37] ^= 0x10;
+        diff_master[c * Panel::HEIGHT + 200] ^= 0x81;
+    }
+    dirty_bits[0] = 0x0FF00F0Fu;
+    dirty_bits[1] = 0x80000001u;
+    dirty_bits[2] = 0xFFFF0000u;
+    dirty_bits[3] = 0x00000003u;
+}
+
+static void bitrev_bytewise()
+{
+    for (uint8_t &b : src_frame)
+        b = Panel::bitrev8(b);
+}
+
+static void bitrev_words()
+{
+    for (size_t i = 0; i + 4 <= sizeof(src_frame); i += 4)
+        ssd1683_bits::store_u32(src_frame + i, ssd1683_bits::rev_each_byte(ssd1683_bits::load_u32(src_frame + i)));
+}
+
+template <bool WORDS>
+static void diff_columns()
+{
+    uint32_t acc = 0;
+    for (int c = 0; c < Panel::MASTER_COLS; ++c)
+    {
+        const uint8_t *a = out_master + c * Panel::HEIGHT, *b = diff_master + c * Panel::HEIGHT;
+        int lo = 0, hi = Panel::HEIGHT - 1;
+        if constexpr (WORDS)
+        {
+            if (!ssd1683_bits::diff_span(a, b, Panel::HEIGHT, lo, hi))
+                continue;
+        }
+        else
+        {
+            while (lo < Panel::HEIGHT && a[lo] == b[lo])
+                ++lo;
+            if (lo == Panel::HEIGHT)
+                continue;
+            while (a[hi] == b[hi])
+                --hi;
+        }
+        acc += (uint32_t)(lo + hi);
+    }
+    sink = acc;
+}
+
+static void popcount_bytewise()
+{
+    uint32_t n = 0;
+    for (int i = 0; i < Panel::MASTER_PLANE_BYTES; ++i)
+        for (uint8_t x = out_master[i] ^ diff_master[i]; x; x &= (uint8_t)(x - 1))
+            ++n;
+    sink = n;
+}
+
+static void popcount_words()
+{
+    sink = ssd1683_bits::diff_count(out_master, diff_master, Panel::MASTER_PLANE_BYTES);
+}
+
+// Dirty-column runs of a 100-column bitset, 100 times over
+template <bool WORDS>
+static void run_scan()
+{
+    constexpr int N = 100;
+    uint32_t acc = 0;
+    for (int rep = 0; rep < 100; ++rep)
+    {
+        int g = 0;
+        while (true)
+        {
+            int g1;
+            if constexpr (WORDS)
+            {
+                g = ssd1683_bits::next_set(dirty_bits, g, N);
+                if (g >= N)
+                    break;
+                g1 = ssd1683_bits::next_clear(dirty_bits, g, N);
+            }
+            else
+            {
+                while (g < N && !((dirty_bits[g >> 5] >> (g & 31)) & 1u))
+                    ++g;
+                if (g >= N)
+                    break;
+                g1 = g;
+                while (g1 < N && ((dirty_bits[g1 >> 5] >> (g1 & 31)) & 1u))
+                    ++g1;
+            }
+            acc += (uint32_t)(g1 - g);
+            g = g1;
+        }
+    }
+    sink = acc;
+}
+
+// Every frame row shifted by 3 bits (the last byte reads into the next row)
+template <bool WORDS>
+static void shift_rows()
+{
+    for (int y = 0; y + 1 < Panel::FRAME_HEIGHT; ++y)
+    {
+        const uint8_t *row = src_frame + y * Panel::FRAME_BPR;
+        if constexpr (WORDS)
+            ssd1683_bits::shift_row(shift_out, row, Panel::FRAME_BPR, 3);
+        else
+            for (int k = 0; k < Panel::FRAME_BPR; ++k)
+                shift_out[k] = (uint8_t)((row[k] << 3) | (row[k + 1] >> 5));
+    }
+}
+
+// The firmware's frame load: transform kernel in SRAM (as load_frame in the main loop)
+static void __attribute__((flatten)) MW_RAM_FUNC(transform_sram)(const uint8_t *frame, uint8_t *master, uint8_t *slave)
+{
+    ssd1683_transform_rowmajor<PanelGDEY0579T93>(frame, master, slave);
+}
+
+// ---------------- Correctness ----------------
+// Every kernel against a per-pixel or byte-at-a-time reference, before anything is
+// timed. One line per check: "check <name>: ok" or "check <name>: FAIL".
+//
+// The orientations take turns in check_store: planes are glass-sized, so every
+// orientation's frame has the same size. band_out holds the expected image.
+alignas(4) static uint8_t check_store[sizeof(SSD1683NativeFrame<PanelGDEY0579T93>)];
+static int check_failures;
+
+static void check(const char *kind, const char *variant, bool ok)
+{
+    printf("check %s%s%s: %s\n", kind, *variant ? "_" : "", variant, ok ? "ok" : "FAIL");
+    if (!ok)
+        ++check_failures;
+}
+
+static bool rm_black(const uint8_t *image, int bpr, int x, int y)
+{
+    return (image[y * bpr + (x >> 3)] & (0x80u >> (x & 7))) == 0;
+}
+
+// Every frame pixel of f against a row-major image, and the overlap column's two copies
+template <typename Frame>
+static bool matches(const Frame &f, const uint8_t *image)
+{
+    using P = typename Frame::Panel;
+    for (int y = 0; y < Frame::HEIGHT; ++y)
+        for (int x = 0; x < Frame::WIDTH; ++x)
+            if (f.get_pixel(x, y) != rm_black(image, P::FRAME_BPR, x, y))
+                return false;
+    for (int c = P::SLAVE_START; c < P::MASTER_COLS; ++c)
+        if (memcmp(f.master + c * P::HEIGHT, f.slave + (c - P::SLAVE_START) * P::HEIGHT, P::HEIGHT) != 0)
+            return false;
+    return true;
+}
+
+// x, y, w, h, dx, dy: byte aligned, odd offsets both ways, and clipped on every side
+static constexpr int MOVES[][6] = {
+    {96, 40, 160, 32, 8, 0},
+    {100, 40, 160, 32, 5, 0},
+    {37, 21, 90, 50, -13, 3},
+    {3, 2, 250, 120, 9, -7},
+    {-8, 100, 60, 60, -20, 200},
+    {200, 150, 400, 400, 700, 1},
+};
+
+template <typename Traits>
+static void check_orientation(const char *name)
+{
+    using Frame = SSD1683NativeFrame<Traits>;
+    static_assert(sizeof(Frame) == sizeof(check_store), "orientations share check_store");
+    static_assert(Frame::Panel::FRAME_BYTES == sizeof(src_frame), "orientations share src_frame");
+    constexpr int BPR = Frame::Panel::FRAME_BPR;
+    Frame &f = *new (check_store) Frame;
+
+    f.load_row_major(src_frame);
+    check("transform", name, matches(f, src_frame));
+
+    bool ok = true;
+    for (const auto &m : MOVES)
+    {
+        // Expected: each source pixel read from the unmoved image (memmove semantics)
+        memcpy(band_out, src_frame, sizeof(src_frame));
+        for (int y = m[1]; y < m[1] + m[3]; ++y)
+            for (int x = m[0]; x < m[0] + m[2]; ++x)
+            {
+                const int tx = x + m[4], ty = y + m[5];
+                if (x < 0 || y < 0 || x >= Frame::WIDTH || y >= Frame::HEIGHT || tx < 0 || ty < 0 ||
+                    tx >= Frame::WIDTH || ty >= Frame::HEIGHT)
+                    continue;
+                uint8_t &b = band_out[ty * BPR + (tx >> 3)];
+                if (rm_black(src_frame, BPR, x, y))
+                    b &= (uint8_t)~(0x80u >> (tx & 7));
+                else
+                    b |= (uint8_t)(0x80u >> (tx & 7));
+            }
+
+        f.load_row_major(src_frame);
+        f.copy_rect(m[0], m[1], m[2], m[3], m[4], m[5]);
+        ok = ok && matches(f, band_out);
+    }
+    check("copy_rect", name, ok);
+}
+
+static uint32_t popcount_naive(uint32_t x)
+{
+    uint32_t n = 0;
+    for (; x; x &= x - 1)
+        ++n;
+    return n;
+}
+
+static void check_bits()
+{
+    transform_bytewise(src_frame, out_master, out_slave);
+    ssd1683_transform_rowmajor<PanelGDEY0579T93>(src_frame, blit_frame.master, blit_frame.slave);
+    check("transform_tiled32", "", memcmp(out_master, blit_frame.master, sizeof(out_master)) == 0 &&
+                                       memcmp(out_slave, blit_frame.slave, sizeof(out_slave)) == 0);
+
+    bool ok = true;
+    for (int b = 0; b < 256; ++b)
+        ok = ok && ssd1683_bits::rev8((uint8_t)b) == Panel::bitrev8((uint8_t)b);
+    memcpy(band_out, src_frame, sizeof(src_frame));
+    bitrev_words();
+    for (size_t i = 0; i < sizeof(src_frame); ++i)
+        ok = ok && src_frame[i] == Panel::bitrev8(band_out[i]);
+    memcpy(src_frame, band_out, sizeof(src_frame));
+    check("bitrev", "", ok);
+
+    build_diff();
+    diff_columns<false>();
+    uint32_t want = sink;
+    diff_columns<true>();
+    check("diff_span", "", sink == want);
+
+    popcount_bytewise();
+    want = sink;
+    popcount_words();
+    ok = sink == want;
+    uint32_t x = 0x2545F491u;
+    for (int i = 0; i < 1000; ++i)
+    {
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        ok = ok && (uint32_t)ssd1683_bits::popcount(x) == popcount_naive(x);
+    }
+    check("popcount", "", ok);
+
+    // Run scanning: every start (and every range end) over the bench bitset
+    constexpr int N = 100;
+    auto bit = [](int i) { return ((dirty_bits[i >> 5] >> (i & 31)) & 1u) != 0; };
+    ok = true;
+    for (int i = 0; i <= N; ++i)
+    {
+        int s = i, c = i, e = 0;
+        while (s < N && !bit(s))
+            ++s;
+        while (c < N && bit(c))
+            ++c;
+        for (int k = 0; k < i; ++k)
+            if (bit(k))
+                e = k + 1;
+        ok = ok && ssd1683_bits::next_set(dirty_bits, i, N) == s && ssd1683_bits::next_clear(dirty_bits, i, N) == c &&
+             ssd1683_bits::end_of_set(dirty_bits, 0, i) == e;
+    }
+    check("run_scan", "", ok);
+
+    ok = true;
+    for (int shift = 0; shift < 8; ++shift)
+        for (int y = 0; y + 1 < Panel::FRAME_HEIGHT; ++y)
+        {
+            const uint8_t *row = src_frame + y * Panel::FRAME_BPR;
+            ssd1683_bits::shift_row(shift_out, row, Panel::FRAME_BPR, shift);
+            for (int k = 0; k < Panel::FRAME_BPR; ++k)
+                ok = ok && shift_out[k] == (uint8_t)((row[k] << shift) | (shift ? row[k + 1] >> (8 - shift) : 0));
+        }
+    check("shift_row", "", ok);
+}
+
+static void run_checks()
+{
+    check_bits();
+    check_orientation<SSD1683Rotated<PanelGDEY0579T93, 0>>("rot0");
+    check_orientation<SSD1683Rotated<PanelGDEY0579T93, 90>>("rot90");
+    check_orientation<SSD1683Rotated<PanelGDEY0579T93, 180>>("rot180");
+    check_orientation<SSD1683Rotated<PanelGDEY0579T93, 270>>("rot270");
+    check_orientation<SSD1683Rotated<PanelGDEY0579T93, 0, true>>("rot0m");
+    check_orientation<SSD1683Rotated<PanelGDEY0579T93, 90, true>>("rot90m");
+    check_orientation<SSD1683Rotated<PanelGDEY0579T93, 180, true>>("rot180m");
+    check_orientation<SSD1683Rotated<PanelGDEY0579T93, 270, true>>("rot270m");
+    printf("check failures: %d\n", check_failures);
+}
+
+template <typename Fn>
+static void bench(const char *name, Fn fn)
+{
+    fn(); // warm the XIP cache
+    uint64_t t0 = time_us_64();
+    for (int i = 0; i < ITERS; ++i)
+        fn();
+    uint64_t dt = time_us_64() - t0;
+    printf("bench %s: %u us\n", name, (unsigned)(dt / ITERS));
+}
+
+// The same with the XIP cache emptied before every call, as after a flash write
+// or when the main loop's other work has evicted the kernel. Warm runs hide where
+// code lives; these are the ones that differ between MINDWRITE_SRAM_PLACEMENT
+// builds (frame data is in SRAM either way).
+template <typename Fn>
+static void bench_cold(const char *name, Fn fn)
+{
+    uint64_t dt = 0;
+    for (int i = 0; i < ITERS; ++i)
+    {
+        xip_cache_invalidate_all();
+        uint64_t t0 = time_us_64();
+        fn();
+        dt += time_us_64() - t0;
+    }
+    printf("bench %s_cold: %u us\n", name, (unsigned)(dt / ITERS));
+}
+
+void kernel_bench_run()
+{
+    // Tag for pc/bench_compare.py: kernel set, and "-xip" when hot code stays in flash
+    printf("bench arch: %s%s\n", ssd1683_bits::ARCH, MINDWRITE_SRAM_PLACEMENT ? "" : "-xip");
+
+    for (size_t i = 0; i < sizeof(src_frame); ++i)
+        src_frame[i] = (uint8_t)(i * 131u + (i >> 7));
+
+    run_checks();
+
+    bench("transform_bytewise", []
+          { transform_bytewise(src_frame, out_master, out_slave); });
+    bench("transform_tiled32", []
+          { ssd1683_transform_rowmajor<PanelGDEY0579T93>(src_frame, out_master, out_slave); });
+    bench("transform_sram", []
+          { transform_sram(src_frame, out_master, out_slave); });
+    bench_cold("transform_sram", []
+               { transform_sram(src_frame, out_master, out_slave); });
+    bench("transform_rot180", []
+          { ssd1683_transform_rowmajor<SSD1683Rotated<PanelGDEY0579T93, 180>>(src_frame, out_master, out_slave); });
+    bench("transform_rot90", []
+          { ssd1683_transform_rowmajor<SSD1683Rotated<PanelGDEY0579T93, 90>>(src_frame, out_master, out_slave); });
+
+    build_diff();
+    bench("bitrev_bytewise", bitrev_bytewise);
+    bench("bitrev_words", bitrev_words);
+    bench("diff_bytewise", diff_columns<false>);
+    bench("diff_words", diff_columns<true>);
+    bench("popcount_bytewise", popcount_bytewise);
+    bench("popcount_words", popcount_words);
+    bench("run_scan_bits", run_scan<false>);
+    bench("run_scan_words", run_scan<true>);
+    bench("shift_row_bytewise", shift_rows<false>);
+    bench("shift_row_words", shift_rows<true>);
+
+    bench("blit_pixels", blit_glyphs_pixels);
+    bench("blit_plain", blit_glyphs<PlainWalk>);
+#if MINDWRITE_INTERP
+    bench("blit_interp", blit_glyphs<InterpWalk>);
+#endif
+    bench("copy_line", copy_line);
+    bench("redraw_line", redraw_line);
+
+    // Ingestion: parse + CRC + copy of one frame from a zero-copy transport
+    build_packet();
+    static MemoryTransport replay(packet, sizeof(packet));
+    alignas(4) static uint8_t rx_buf[Panel::FRAME_BYTES + MW_RECT_HEADER];
+    static FrameReceiver rx(replay, Panel::FRAME_BYTES, rx_buf);
+    bench("crc32_frame", []
+          { sink = crc32_compute(src_frame, sizeof(src_frame)); });
+    bench_cold("crc32_frame", []
+               { sink = crc32_compute(src_frame, sizeof(src_frame)); });
+    bench("parse_frame", []
+          {
+              FrameMessage m;
+              replay.rewind();
+              while (!rx.poll(m, sizeof(packet)))
+                  ;
+          });
+    bench_cold("parse_frame", []
+               {
+                   FrameMessage m;
+                   replay.rewind();
+                   while (!rx.poll(m, sizeof(packet)))
+                       ;
+               });
+
+    // Banded decode on one core, then on both (BandDecoder::start() ran before)
+    build_bands();
+    bench("decode_bands_1core", []
+          { BandDecoder::decode(bands, bands_len, band_out, Panel::FRAME_BPR, Panel::FRAME_HEIGHT, 1); });
+    bench_cold("decode_bands_1core", []
+               { BandDecoder::decode(bands, bands_len, band_out, Panel::FRAME_BPR, Panel::FRAME_HEIGHT, 1); });
+    bench("decode_bands_2core", []
+          { BandDecoder::decode(bands, bands_len, band_out, Panel::FRAME_BPR, Panel::FRAME_HEIGHT, 2); });
+
+    stdio_flush();
+}
@@ -0,0 +1,10 @@
+#pragma once
+
+// Boot-time micro-benchmarks for the pixel kernels (build with -DMINDWRITE_BENCH=ON).
+// Results are printed on stdio before streaming starts. First each kernel's output
+// is compared with a reference, then each is timed:
+//   check <name>: ok|FAIL
+//   bench <name>: <us per call> us
+// <name>_cold rows repeat a kernel with the XIP cache flushed before each call, so
+// they show what MINDWRITE_SRAM_PLACEMENT buys (see pc/bench_compare.py).
+void kernel_bench_run();
@@ -0,0 +1,45 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+#include "transport.h"
+
+// Plays a recorded byte stream from memory (flash or RAM), e.g. for replaying a
+// captured session on the bench or timing the parser without a host. Peeks are
+// zero-copy views into the recording; writes (ACKs) are only counted.
+class MemoryTransport : public Transport
+{
+public:
+    MemoryTransport(const uint8_t *data, size_t len, bool loop = false)
+        : data_(data), len_(len), loop_(loop) {}
+
+    const char *name() const override { return "replay"; }
+
+    const uint8_t *peek(size_t &n) override
+    {
+        if (pos_ == len_ && loop_)
+            pos_ = 0;
+        n = len_ - pos_;
+        return data_ + pos_;
+    }
+
+    void consume(size_t n) override { pos_ += n; }
+
+    void write(const uint8_t *src, size_t n) override
+    {
+        (void)src;
+        written_ += n;
+    }
+
+    bool connected() const override { return true; }
+
+    void rewind() { pos_ = 0; }
+    size_t written() const { return written_; }
+
+private:
+    const uint8_t *data_;
+    size_t len_;
+    size_t pos_ = 0;
+    bool loop_;
+    size_t written_ = 0;
+};
@@ -5,200 +5,1222 @@
 #include "pico/stdlib.h"
 #include "pico/stdio.h"
 
+#include "hardware/adc.h"
+#include "hardware/dma.h"
 #include "hardware/gpio.h"
+#include "hardware/irq.h"
 #include "hardware/spi.h"
 
+#include "band_decoder.h"
+#include "epd/ssd1683_native_frame.h"
+#include "executor.h"
+#include "frame_protocol.h"
+#include "refresh_model.h"
+#include "refresh_scheduler.h"
+#include "settings.h"
+#include "sram_placement.h"
+#include "supervisor.h"
+#include "frame_receiver.h"
+#include "usb_transport.h"
+#if MINDWRITE_WIFI
+#include "pico/cyw43_arch.h"
+#include "net_transport.h"
+#endif
+
+// Panel model and mounting are picked at configure time
+// (-DMINDWRITE_PANEL=..., -DMINDWRITE_ROTATION=0|90|180|270, -DMINDWRITE_MIRROR_X=ON)
+#if defined(MINDWRITE_PANEL_GDEY042T81)
+#include "epd/ssd1683_gdey042t81.h"
+using EPDGlass = PanelGDEY042T81;
+#else
 #include "epd/ssd1683_gdey0579t93.h"
+using EPDGlass = PanelGDEY0579T93;
+#endif
+
+#ifndef MINDWRITE_ROTATION
+#define MINDWRITE_ROTATION 0
+#endif
+#ifndef MINDWRITE_MIRROR_X
+#define MINDWRITE_MIRROR_X 0
+#endif
+
+using EPDPanel = SSD1683Rotated<EPDGlass, MINDWRITE_ROTATION, MINDWRITE_MIRROR_X>;
 
-// Panel: 792x272, 1bpp
-static constexpr int EPD_W = 792;
-static constexpr int EPD_H = 272;
-static constexpr int BYTES_PER_ROW = (EPD_W + 7) / 8;     // 99
-static constexpr int FRAME_BYTES = BYTES_PER_ROW * EPD_H; // 26928
+using EPD = SSD1683<EPDPanel>;
+using EPDFrame = SSD1683NativeFrame<EPDPanel>;
+
+#if MINDWRITE_BENCH
+#include "kernel_bench.h"
+#endif
+
+// Frame: 1bpp in the mounted orientation, e.g. 792x272 -> 99 bytes/row, 26928 bytes/frame
+static constexpr int EPD_W = EPD::FRAME_WIDTH;
+static constexpr int EPD_H = EPD::FRAME_HEIGHT;
+static constexpr int FRAME_BYTES = EPD::FRAME_BYTES;
 
 // ========= PIN MAP (edit to match your wiring) =========
-static constexpr uint PIN_CS = 17;
-static constexpr uint PIN_DC = 20;
-static constexpr uint PIN_RST = 21;
-static constexpr uint PIN_BUSY = 22;
+// All panels share SPI0 SCK/MOSI; each has its own CS/DC/RST/BUSY.
+struct PanelPins
+{
+    uint cs, dc, rst, busy;
+};
+
+static constexpr PanelPins PANEL_PINS[] = {
+    {17, 20, 21, 22}, // panel 0
+    {13, 14, 15, 16}, // panel 1
+    {9, 10, 11, 12},  // panel 2
+    {5, 6, 7, 8},     // panel 3
+};
 
 static constexpr uint PIN_SCK = 18;  // SPI0 SCK
 static constexpr uint PIN_MOSI = 19; // SPI0 TX (MOSI)
+// Status LED. The Pico 2 W's own LED hangs off the radio chip, and GPIO 25 is the
+// radio's SPI chip select, so with Wi-Fi the LED goes through cyw43; without it an
+// external LED on this pin is used.
+static constexpr uint PIN_LED = 2;
 // ======================================================
 
-static constexpr uint32_t SPI_HZ = 20'000'000;
+#ifndef MINDWRITE_PANEL_COUNT
+#define MINDWRITE_PANEL_COUNT 1
+#endif
+static constexpr int PANEL_COUNT = MINDWRITE_PANEL_COUNT;
+static_assert(PANEL_COUNT >= 1 && PANEL_COUNT <= (int)(sizeof(PANEL_PINS) / sizeof(PANEL_PINS[0])),
+              "MINDWRITE_PANEL_COUNT exceeds PANEL_PINS");
+
+static constexpr uint32_t SPI_HZ_DEFAULT = 20'000'000; // until calibrated (see calibrate_spi)
+
+#ifndef MINDWRITE_TELEMETRY_MS
+#define MINDWRITE_TELEMETRY_MS 0
+#endif
+#ifndef MINDWRITE_VERIFY_RAM
+#define MINDWRITE_VERIFY_RAM 0
+#endif
+#ifndef MINDWRITE_REF_SLOTS
+#define MINDWRITE_REF_SLOTS 4
+#endif
+#ifndef MINDWRITE_HW_SEQUENCE
+#define MINDWRITE_HW_SEQUENCE 0
+#endif
+// The PIO sequencer owns the SPI pins for a whole upload, BUSY wait included
+static_assert(!MINDWRITE_HW_SEQUENCE || PANEL_COUNT == 1, "MINDWRITE_HW_SEQUENCE drives a single panel");
 
-static void blink_status(uint pin, int times, int ms)
+static void make_test_pattern(EPDFrame &fb)
 {
-    for (int i = 0; i < times; i++)
+    fb.clear(); // white
+
+    // chunky checkerboard (very obvious if mapping is correct)
+    for (int y = 0; y < EPD_H; y += 24)
     {
-        gpio_put(pin, 1);
-        sleep_ms(ms);
-        gpio_put(pin, 0);
-        sleep_ms(ms);
+        for (int x = 0; x < EPD_W; x += 24)
+        {
+            bool black = (((x / 24) + (y / 24)) % 2) == 0;
+            if (black)
+                fb.fill_rect(x, y, 24, 24, true);
+        }
     }
 }
 
-static void make_test_pattern(uint8_t *fb)
+// ================= Pipeline =================
+// Everything below runs as Executor tasks. Nothing on this path sleeps: USB input,
+// DMA completion and BUSY release arrive as IRQs that post the task to run next.
+//
+//   rx       parse/CRC incoming bytes (budgeted), convert a finished frame into its
+//            panel's pending frame, ACK; apply control messages
+//   panels   own the shared SPI bus: advance the running DMA upload (parking or
+//            restarting a background one when interactive damage arrives), then
+//            commit the next panel whose RefreshScheduler says go
+//   led      non-blocking blink patterns
+//   telemetry  optional periodic counters (MINDWRITE_TELEMETRY_MS)
+//   supervise  stall detection, recovery ladder, watchdog feed (Supervisor)
+//   spi_check  periodic re-validation of the calibrated SPI clock
+
+static Executor exec;
+static int task_rx = -1;
+static int task_panels = -1;
+static int task_led = -1;
+static int task_telemetry = -1;
+static int task_supervise = -1;
+static int task_link_attach = -1;
+static int task_links = -1;
+
+using Lane = RefreshScheduler::Lane;
+
+// The committed frame of each panel lives in RAM the C runtime does not clear, so
+// it survives a watchdog/supervisor reboot; a checksum tells it from power-on noise.
+struct PersistedFrame
 {
-    memset(fb, 0xFF, FRAME_BYTES); // white
+    uint32_t magic;
+    uint32_t sum;
+    EPDFrame frame;
+};
+static PersistedFrame __uninitialized_ram(persisted)[PANEL_COUNT];
+static constexpr uint32_t PERSIST_MAGIC = 0x4D575046u; // "MWPF"
 
-    // chunky checkerboard (very obvious if mapping is correct)
-    for (int y = 0; y < EPD_H; ++y)
+// Fletcher-style sum over the frame words (~30 us for a 792x272 frame)
+static uint32_t persist_sum(const EPDFrame &f)
+{
+    const uint32_t *w = (const uint32_t *)&f;
+    uint32_t a = 0, b = 0;
+    for (size_t i = 0; i < sizeof(EPDFrame) / 4; ++i)
+    {
+        a += w[i];
+        b += a;
+    }
+    return a ^ (b << 1) ^ (b >> 31);
+}
+
+static bool persist_valid(const PersistedFrame &p)
+{
+    return p.magic == PERSIST_MAGIC && p.sum == persist_sum(p.frame);
+}
+
+// One per panel. rx always writes `pending` (newest frame wins); a commit copies it
+// to `shown` (persisted), which is what gets uploaded and what new frames are diffed against.
+struct PanelSlot
+{
+    EPD *epd = nullptr;
+    EPDFrame pending;
+    EPDFrame *shown = nullptr;
+    RefreshScheduler sched;
+    Lane lane = Lane::BACKGROUND; // of the last commit; background uploads are preemptible
+    int stage = -1;               // Supervisor stage
+    uint32_t uploads = 0;         // finished uploads; progress for the supervisor
+    uint32_t uploads_seen = 0;
+
+    // Refresh timing (RefreshModel): the refresh on the glass and the one being uploaded
+    RefreshModel model;
+    bool refreshing = false;
+    absolute_time_t refresh_start = 0;
+    uint32_t refresh_pred = 0;
+    uint8_t commit_area = 0; // damage of the last commit
+    int refresh_temp = 0;
+    absolute_time_t upload_start = 0;
+    uint32_t upload_ms = 30;                // last upload, SPI + bus waits
+    volatile uint64_t busy_release_us = 0; // last BUSY release edge (IRQ)
+
+    int verify_next = -1; // next plane column to read back (MINDWRITE_VERIFY_RAM), -1 = none
+    bool verify_bad = false;
+};
+
+// RAM readback after each refresh goes this many plane columns per panels run
+// (~10 ms each), so receive and interactive work keep flowing in between
+static constexpr int VERIFY_SLICE_COLS = 4;
+
+// Background uploads go out in slices this size, so an interactive update waits
+// at most one slice (~1.6 ms at 20 MHz) for the shared bus
+static constexpr uint32_t UPLOAD_SLICE_BYTES = 4096;
+
+// MWZ1 bands decode into this row-major frame, then convert like an MWF1 payload
+alignas(4) static uint8_t band_frame[FRAME_BYTES];
+
+// Reference frames for MWD1 deltas, shared by all panels; empty until the host stores one
+static constexpr int REF_SLOTS = MINDWRITE_REF_SLOTS;
+static EPDFrame ref_frames[REF_SLOTS > 0 ? REF_SLOTS : 1];
+static bool ref_valid[REF_SLOTS > 0 ? REF_SLOTS : 1];
+
+// Row-major frame -> pending planes, with the transform kernel flattened into this
+// SRAM-resident function (see sram_placement.h)
+static void __attribute__((flatten)) MW_RAM_FUNC(load_frame)(EPDFrame &f, const uint8_t *frame)
+{
+    f.load_row_major(frame);
+}
+
+static PanelSlot slots[PANEL_COUNT];
+static int bus_owner = -1; // panel whose upload (from shown) is on the SPI bus
+static int suspended = -1; // background upload parked between slices
+static int next_panel = 0; // round-robin start for fairness
+
+// Every transport feeds the same pipeline; ACKs go back on the link a message came from
+struct Link
+{
+    Transport *t = nullptr;
+    FrameReceiver *rx = nullptr;
+    int stage = -1; // Supervisor stage
+    uint32_t bytes_seen = 0;
+    bool reattach = false;
+    bool timing = false;           // host asked for timing ACKs (MW_CTL_TIMING)
+    volatile bool dropped = false; // DOWN event seen (may be set from IRQ)
+};
+
+static constexpr int MAX_LINKS = 2;
+static Link links[MAX_LINKS];
+alignas(4) static uint8_t rx_buf[MAX_LINKS][FRAME_BYTES + MW_RECT_HEADER]; // one message per link
+static int link_count = 0;
+
+static UsbTransport usb_link;
+#if MINDWRITE_WIFI
+static NetTransport net_link(MINDWRITE_NET_PORT);
+#endif
+
+struct Stats
+{
+    uint32_t frames = 0;
+    uint32_t coalesced = 0; // frames merged into damage that was still pending
+    uint32_t uploads = 0;
+    uint32_t upload_bytes = 0; // SPI payload actually sent (unchanged columns are skipped)
+    uint32_t ram_bad = 0;      // plane columns that read back wrong (MINDWRITE_VERIFY_RAM)
+};
+static Stats stats;
+
+// ---------------- Supervision ----------------
+// Stall thresholds: a full upload takes ~25 ms and a full refresh ~3 s, so a panel
+// with work in flight for PANEL_STALL_MS is wedged. A message that stops mid-way for
+// RX_STALL_MS means a lost byte or a wedged link. The watchdog catches a
+// main loop that stops running altogether.
+static constexpr uint32_t PANEL_STALL_MS = 5000;
+static constexpr uint32_t RX_STALL_MS = 500;
+static constexpr uint32_t SUPERVISE_MS = 100;
+static constexpr uint32_t WATCHDOG_MS = 2000;
+
+static Supervisor sup;
+static constexpr uint32_t LINK_DETACH_MS = 250;
+static constexpr uint32_t LINK_SERVICE_MS = 250; // link state polling, Wi-Fi listener
+
+static bool led_on = false;
+static int led_toggles = 0;
+static uint32_t led_half_ms = 0;
+
+static void led_put(bool on)
+{
+#if MINDWRITE_WIFI
+    if (net_link.radio_ready())
+        cyw43_arch_gpio_put(CYW43_WL_GPIO_LED_PIN, on);
+#else
+    gpio_put(PIN_LED, on);
+#endif
+}
+
+static void led_blink(int times, uint32_t ms)
+{
+    led_toggles = times * 2;
+    led_half_ms = ms;
+    exec.post(task_led);
+}
+
+static void led_task(void *)
+{
+    if (led_toggles <= 0)
+        return;
+
+    led_on = !led_on;
+    led_put(led_on);
+    if (--led_toggles > 0)
+        exec.post_in_ms(task_led, led_half_ms);
+}
+
+// Percentage of the glass covered by the pending-vs-shown damage box (0 = none)
+static uint8_t damage_pct(const PanelSlot &s)
+{
+    int c0, c1, y0, y1;
+    if (!s.pending.diff_bounds(*s.shown, c0, c1, y0, y1))
+        return 0;
+
+    uint32_t area = (uint32_t)(c1 - c0) * (uint32_t)(y1 - y0);
+    uint32_t pct = (area * 100 + EPD::BYTES_PER_ROW * EPD::HEIGHT - 1) / (EPD::BYTES_PER_ROW * EPD::HEIGHT);
+    return (uint8_t)pct;
+}
+
+// Panel with interactive damage that can commit right now (not BUSY, not mid-upload)
+static int interactive_ready(int skip)
+{
+    for (int i = 0; i < PANEL_COUNT; ++i)
+    {
+        if (i != skip && i != suspended && slots[i].sched.interactive() && !slots[i].epd->busy())
+            return i;
+    }
+    return -1;
+}
+
+// On-die temperature sensor. Stands in for the glass temperature: the controller's
+// sensor is readable over the SDA readback (0x1B), but only while BUSY is idle, and
+// this is read right after the refresh trigger. A separate sense cycle (0x22/0x20)
+// would add a BUSY wait ahead of every refresh; the ADC read takes microseconds.
+static int read_temp_c()
+{
+    adc_select_input(ADC_TEMPERATURE_CHANNEL_NUM);
+    float v = adc_read() * (3.3f / 4096.0f);
+    return (int)(27.0f - (v - 0.706f) / 0.001721f);
+}
+
+static uint16_t sat16(uint32_t v)
+{
+    return v > 0xFFFF ? 0xFFFF : (uint16_t)v;
+}
+
+static uint32_t ms_between(absolute_time_t from, absolute_time_t to)
+{
+    int64_t us = absolute_time_diff_us(from, to);
+    return us > 0 ? (uint32_t)(us / 1000) : 0;
+}
+
+// Predicted ms until panel i shows its pending damage (with nothing pending: until
+// the refresh in progress ends). The coalescing timers run while the previous
+// refresh does, so the commit waits for whichever ends last.
+static uint32_t eta_ms(int i, absolute_time_t now)
+{
+    PanelSlot &s = slots[i];
+
+    uint32_t busy_left = 0;
+    if (bus_owner == i || suspended == i)
+        busy_left = s.upload_ms + s.model.predict(s.refresh_temp, s.commit_area);
+    else if (s.refreshing)
+    {
+        uint32_t el = ms_between(s.refresh_start, now);
+        busy_left = s.refresh_pred > el ? s.refresh_pred - el : 0;
+    }
+    if (!s.sched.dirty())
+        return busy_left;
+
+    absolute_time_t wake;
+    uint32_t wait = 0;
+    if (s.sched.decide(true, now, wake) == RefreshScheduler::Reason::NONE && !is_at_the_end_of_time(wake))
+        wait = ms_between(now, wake);
+
+    uint32_t start = busy_left > wait ? busy_left : wait;
+    return start + s.upload_ms + s.model.predict(s.refresh_temp, s.sched.area_pct());
+}
+
+// Refresh triggered at the end of an upload
+static void refresh_started(PanelSlot &s)
+{
+    absolute_time_t now = get_absolute_time();
+    s.upload_ms = ms_between(s.upload_start, now);
+    s.refresh_temp = read_temp_c();
+    s.refresh_pred = s.model.predict(s.refresh_temp, s.commit_area);
+    s.refresh_start = now;
+    s.refreshing = true;
+}
+
+// A BUSY release edge after the trigger ends the refresh. Without one (missed edge),
+// an idle BUSY line after MISSED_EDGE_MS does, measured to the nearest panels run.
+static constexpr uint32_t MISSED_EDGE_MS = 100;
+
+static void refresh_finished(int i, absolute_time_t now)
+{
+    PanelSlot &s = slots[i];
+    if (!s.refreshing)
+        return;
+
+    uint64_t start_us = to_us_since_boot(s.refresh_start);
+    uint64_t rel_us = s.busy_release_us;
+    uint32_t busy_ms;
+    if (rel_us > start_us)
+        busy_ms = (uint32_t)((rel_us - start_us) / 1000);
+    else if (!s.epd->busy() && ms_between(s.refresh_start, now) >= MISSED_EDGE_MS)
+        busy_ms = ms_between(s.refresh_start, now);
+    else
+        return;
+
+    s.refreshing = false;
+    s.model.record(s.refresh_temp, s.commit_area, busy_ms);
+    if (MINDWRITE_VERIFY_RAM)
+        s.verify_next = 0;
+    if (s.sched.policy().trace)
+        printf("S p=%d refreshed ms=%lu pred=%lu temp=%d\n", i, (unsigned long)busy_ms,
+               (unsigned long)s.refresh_pred, s.refresh_temp);
+
+    uint16_t eta = s.sched.dirty() ? sat16(eta_ms(i, now)) : 0;
+    for (int k = 0; k < link_count; ++k)
     {
-        for (int x = 0; x < EPD_W; ++x)
+        Link &l = links[k];
+        if (l.timing && l.t->connected())
         {
-            bool black = (((x / 24) + (y / 24)) % 2) == 0;
-            if (black)
+            l.rx->send_refresh_done((uint8_t)i, sat16(busy_ms), eta);
+            l.t->flush();
+        }
+    }
+}
+
+// Read back a slice of one panel's RAM (bus idle, panel idle). Columns that do not
+// match what was uploaded get re-uploaded, and refreshed, on their own. True when
+// a slice ran.
+static bool verify_slice(absolute_time_t now)
+{
+    for (int i = 0; i < PANEL_COUNT; ++i)
+    {
+        PanelSlot &s = slots[i];
+        if (s.verify_next < 0 || s.epd->busy())
+            continue;
+
+        int g = s.verify_next;
+        int bad = s.epd->verify_ram(s.shown->master, s.shown->slave, g, g + VERIFY_SLICE_COLS);
+        if (bad < 0)
+            continue;
+
+        if (bad > 0)
+        {
+            printf("W p=%d ram mismatch cols=%d..%d bad=%d\n", i, g, g + VERIFY_SLICE_COLS - 1, bad);
+            stats.ram_bad += (uint32_t)bad;
+            s.verify_bad = true;
+        }
+
+        s.verify_next = g + VERIFY_SLICE_COLS;
+        if (s.verify_next >= EPD::plane_columns())
+        {
+            s.verify_next = -1;
+            if (s.verify_bad)
+                s.sched.damage(100, now); // glass shows the wrong columns: refresh now
+            s.verify_bad = false;
+        }
+        return true;
+    }
+    return false;
+}
+
+static void panels_task(void *)
+{
+    absolute_time_t t0 = get_absolute_time();
+    for (int i = 0; i < PANEL_COUNT; ++i)
+        refresh_finished(i, t0);
+
+    if (bus_owner >= 0)
+    {
+        PanelSlot &s = slots[bus_owner];
+
+        // Background upload in flight: interactive damage jumps the queue at the next
+        // slice boundary. Same panel: restart with the merged frame (nothing has been
+        // refreshed yet). Other panel: park this upload and give that one the bus.
+        if (s.lane == Lane::BACKGROUND)
+        {
+            int hi = s.sched.interactive() ? bus_owner : interactive_ready(bus_owner);
+            if (hi == bus_owner)
+            {
+                s.epd->upload_abort();
+                if (s.sched.policy().trace)
+                    printf("S p=%d preempt restart\n", bus_owner);
+                bus_owner = -1;
+            }
+            else if (hi >= 0 && suspended < 0 && s.epd->upload_suspend())
+            {
+                if (s.sched.policy().trace)
+                    printf("S p=%d preempt by p=%d\n", bus_owner, hi);
+                suspended = bus_owner;
+                bus_owner = -1;
+            }
+        }
+
+        // Advance the upload that owns the bus; each DMA completion IRQ brings us back
+        if (bus_owner >= 0)
+        {
+            if (s.epd->upload_poll())
+                return;
+
+            bus_owner = -1; // refresh triggered; shown may be replaced again
+            refresh_started(s);
+            s.uploads++;
+            stats.uploads++;
+            stats.upload_bytes += s.epd->last_upload_bytes();
+        }
+    }
+
+    // A parked background upload resumes once no interactive work is waiting for the bus
+    if (suspended >= 0 && interactive_ready(-1) < 0)
+    {
+        bus_owner = suspended;
+        suspended = -1;
+        exec.post(task_panels);
+        return;
+    }
+
+    absolute_time_t now = get_absolute_time();
+    absolute_time_t wake = at_the_end_of_time;
+    bool waiting = false;
+
+    // Two passes: interactive damage first, then everything else
+    for (int pass = 0; pass < 2; ++pass)
+    {
+        for (int n = 0; n < PANEL_COUNT; ++n)
+        {
+            int i = (next_panel + n) % PANEL_COUNT;
+            PanelSlot &s = slots[i];
+            if (i == suspended || !s.sched.dirty() || (pass == 0 && !s.sched.interactive()))
+                continue;
+
+            // A hardware-sequenced upload may be armed while the glass is still refreshing
+            bool idle = !s.epd->busy() || s.epd->queues_while_busy();
+            absolute_time_t w;
+            RefreshScheduler::Reason r = s.sched.decide(idle, now, w);
+            if (r == RefreshScheduler::Reason::NONE)
             {
-                int byte_i = y * BYTES_PER_ROW + (x / 8);
-                int bit = 7 - (x % 8);
-                fb[byte_i] &= ~(1u << bit); // 0 = black
+                if (!idle)
+                    waiting = true; // still refreshing the previous frame
+                if (absolute_time_diff_us(w, wake) > 0)
+                    wake = w;
+                continue;
             }
+
+            if (s.sched.policy().trace)
+                printf("S p=%d commit reason=%s age=%lu area=%u\n", i, RefreshScheduler::reason_name(r),
+                       (unsigned long)s.sched.age_ms(now), s.sched.area_pct());
+
+            s.lane = s.sched.interactive() ? Lane::INTERACTIVE : Lane::BACKGROUND;
+            s.commit_area = s.sched.area_pct();
+            s.upload_start = now;
+            s.verify_next = -1; // RAM is about to be rewritten anyway
+            PersistedFrame &pf = persisted[i];
+            pf.magic = 0; // invalid while being rewritten
+            memcpy(s.shown, &s.pending, sizeof(EPDFrame));
+            pf.sum = persist_sum(pf.frame);
+            pf.magic = PERSIST_MAGIC;
+            s.sched.committed();
+            bus_owner = i;
+            next_panel = (i + 1) % PANEL_COUNT;
+            s.epd->start_full_native(s.shown->master, s.shown->slave);
+            if (!s.epd->uploading())
+                exec.post(task_panels); // nothing changed in RAM: no DMA IRQ will follow
+            return;
         }
     }
+
+    if (MINDWRITE_VERIFY_RAM && suspended < 0 && verify_slice(now))
+    {
+        exec.post(task_panels);
+        return;
+    }
+
+    // Scheduler timers; BUSY release edges post us, the 50 ms timer only covers a missed edge
+    if (waiting)
+    {
+        absolute_time_t fallback = make_timeout_time_ms(50);
+        if (absolute_time_diff_us(fallback, wake) > 0)
+            wake = fallback;
+    }
+    if (!is_at_the_end_of_time(wake))
+        exec.post_at(task_panels, wake);
 }
 
-// --- CRC32 (bitwise, dependency-free) ---
-static uint32_t crc32_ieee(const uint8_t *data, size_t len)
+static uint16_t u16le(const uint8_t *p)
 {
-    uint32_t crc = 0xFFFFFFFFu;
-    for (size_t i = 0; i < len; i++)
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+// MWC1 message from link l; returns false when it is malformed
+static bool handle_control(const FrameMessage &f, Link &l)
+{
+    const uint8_t *p = f.payload;
+    bool all = (f.panel == MW_CONTROL_ALL_PANELS);
+    if (!all && f.panel >= PANEL_COUNT)
+        return false;
+
+    switch (p[0])
     {
-        crc ^= data[i];
-        for (int k = 0; k < 8; k++)
+    case MW_CTL_REFRESH_POLICY:
+    {
+        if (f.payload_len != 7)
+            return false;
+
+        RefreshScheduler::Policy pol;
+        pol.deadline_ms = u16le(p + 1);
+        pol.quiet_ms = u16le(p + 3);
+        pol.big_area_pct = p[5];
+        pol.trace = p[6] != 0;
+
+        for (int i = 0; i < PANEL_COUNT; ++i)
         {
-            uint32_t mask = -(crc & 1u);
-            crc = (crc >> 1) ^ (0xEDB88320u & mask);
+            if (all || i == f.panel)
+                slots[i].sched.set_policy(pol);
         }
+        exec.post(task_panels); // a shorter deadline may already have passed
+        return true;
+    }
+    case MW_CTL_TIMING:
+        if (f.payload_len != 2)
+            return false;
+        l.timing = p[1] != 0;
+        return true;
+
+    default:
+        return false;
     }
-    return ~crc;
 }
 
-// Read exactly n bytes from USB CDC via getchar_timeout_us.
-// Returns false if it times out.
-static bool read_exact(uint8_t *dst, size_t n, uint32_t timeout_ms)
+// MWR1 payload -> pending frame; false when the header does not match the pixel data
+static bool apply_rect(PanelSlot &s, const FrameMessage &f, Lane &lane)
 {
-    absolute_time_t deadline = make_timeout_time_ms(timeout_ms);
-    size_t got = 0;
+    const uint8_t *p = f.payload;
+    if (p[0] > (uint8_t)Lane::INTERACTIVE)
+        return false;
+
+    int x = u16le(p + 1), y = u16le(p + 3), w = u16le(p + 5), h = u16le(p + 7);
+    int stride = (w + 7) / 8;
+    if (w == 0 || h == 0 || f.payload_len != MW_RECT_HEADER + (uint32_t)(stride * h))
+        return false;
+
+    lane = (Lane)p[0];
+    s.pending.blit_row_major(x, y, w, h, p + MW_RECT_HEADER, stride);
+    return true;
+}
 
-    while (got < n)
+// MWD1/MWM1 rect list from payload offset off: count rects (count < 0: as many as
+// fill the payload) that end exactly at the end of the payload
+static bool rects_valid(const FrameMessage &f, uint32_t off, int count)
+{
+    for (int i = 0; count < 0 ? off < f.payload_len : i < count; ++i)
+    {
+        if (f.payload_len - off < MW_DELTA_RECT)
+            return false;
+        const uint8_t *r = f.payload + off;
+        uint32_t w = u16le(r + 4), h = u16le(r + 6);
+        uint32_t n = (w + 7) / 8 * h;
+        if (w == 0 || h == 0 || n > f.payload_len - off - MW_DELTA_RECT)
+            return false;
+        off += MW_DELTA_RECT + n;
+    }
+    return off == f.payload_len;
+}
+
+// Draw a rect list that rects_valid() accepted
+static void draw_rects(PanelSlot &s, const FrameMessage &f, uint32_t off)
+{
+    while (off < f.payload_len)
     {
-        int c = getchar_timeout_us(1000); // 1ms poll
-        if (c >= 0)
+        const uint8_t *r = f.payload + off;
+        int w = u16le(r + 4), h = u16le(r + 6), stride = (w + 7) / 8;
+        s.pending.blit_row_major(u16le(r), u16le(r + 2), w, h, r + MW_DELTA_RECT, stride);
+        off += MW_DELTA_RECT + (uint32_t)(stride * h);
+    }
+}
+
+// MWD1 payload -> pending frame. Checks the whole message before touching anything;
+// returns 0, or the ER code.
+static uint8_t apply_delta(PanelSlot &s, const FrameMessage &f, Lane &lane)
+{
+    const uint8_t *p = f.payload;
+    const uint8_t ref = p[0], store = p[1];
+    if (p[2] > (uint8_t)Lane::INTERACTIVE || (store != MW_DELTA_NONE && store >= REF_SLOTS))
+        return 0x03;
+    if (!rects_valid(f, MW_DELTA_HEADER, p[3]))
+        return 0x03;
+
+    if (ref != MW_DELTA_CURRENT)
+    {
+        if (ref >= REF_SLOTS)
+            return 0x03;
+        if (!ref_valid[ref])
+            return 0x05;
+        s.pending = ref_frames[ref];
+    }
+    draw_rects(s, f, MW_DELTA_HEADER);
+
+    if (store != MW_DELTA_NONE)
+    {
+        ref_frames[store] = s.pending;
+        ref_valid[store] = true;
+    }
+    lane = (Lane)p[2];
+    return 0;
+}
+
+// MWM1 payload -> pending frame; false when malformed (nothing is changed then)
+static bool apply_move(PanelSlot &s, const FrameMessage &f, Lane &lane)
+{
+    const uint8_t *p = f.payload;
+    if (p[0] > (uint8_t)Lane::INTERACTIVE || !rects_valid(f, MW_MOVE_HEADER, -1))
+        return false;
+
+    s.pending.copy_rect(u16le(p + 1), u16le(p + 3), u16le(p + 5), u16le(p + 7), (int16_t)u16le(p + 9),
+                        (int16_t)u16le(p + 11));
+    draw_rects(s, f, MW_MOVE_HEADER);
+    lane = (Lane)p[0];
+    return true;
+}
+
+// One message from one link; false when the link has nothing (more) right now
+static bool receive(Link &l)
+{
+    FrameReceiver *rx = l.rx;
+    FrameMessage rx_frame;
+    if (!rx->poll(rx_frame))
+        return !rx->drained(); // budget used up with input left: come back
+
+    if (rx_frame.kind == FrameMessage::Kind::CONTROL)
+    {
+        if (handle_control(rx_frame, l))
+            rx->send_ack_ok(rx_frame.panel);
+        else
+            rx->send_ack_err(0x03);
+        rx->link().flush();
+        return true;
+    }
+
+    int panel = rx_frame.panel < 0 ? 0 : rx_frame.panel;
+    if (panel >= PANEL_COUNT)
+        return true; // no such panel -> drop
+
+    // Newest frame replaces whatever was pending; the damage box is measured against
+    // what the panel shows (or is about to show), so changes that undo each other cancel.
+    PanelSlot &s = slots[panel];
+    Lane lane = Lane::BACKGROUND;
+    if (rx_frame.kind == FrameMessage::Kind::RECT)
+    {
+        if (!apply_rect(s, rx_frame, lane))
         {
-            dst[got++] = (uint8_t)c;
-            continue;
+            rx->send_ack_err(0x03);
+            rx->link().flush();
+            return true;
+        }
+    }
+    else if (rx_frame.kind == FrameMessage::Kind::MOVE)
+    {
+        if (!apply_move(s, rx_frame, lane))
+        {
+            rx->send_ack_err(0x03);
+            rx->link().flush();
+            return true;
         }
+    }
+    else if (rx_frame.kind == FrameMessage::Kind::DELTA)
+    {
+        uint8_t err = apply_delta(s, rx_frame, lane);
+        if (err)
+        {
+            rx->send_ack_err(err);
+            rx->link().flush();
+            return true;
+        }
+    }
+    else if (rx_frame.kind == FrameMessage::Kind::BANDS)
+    {
+        if (!BandDecoder::decode(rx_frame.payload, rx_frame.payload_len, band_frame, EPD::FRAME_BPR, EPD_H))
+        {
+            rx->send_ack_err(0x04);
+            rx->link().flush();
+            return true;
+        }
+        load_frame(s.pending, band_frame);
+    }
+    else
+    {
+        load_frame(s.pending, rx_frame.payload);
+    }
 
-        if (absolute_time_diff_us(get_absolute_time(), deadline) <= 0)
-            return false;
+    bool was_dirty = s.sched.dirty();
+    uint8_t pct = damage_pct(s);
+    s.sched.damage(pct, get_absolute_time(), lane);
+    stats.frames++;
+    if (was_dirty)
+        stats.coalesced++;
+
+    if (s.sched.policy().trace)
+        printf("S p=%d %s lane=%u area=%u px=%lu\n", panel, pct == 0 ? "clean" : (was_dirty ? "merge" : "damage"),
+               (unsigned)lane, pct, (unsigned long)s.pending.diff_pixels(*s.shown));
+
+    // ACK once queued so the host can move on (e.g. to another panel)
+    if (l.timing)
+    {
+        absolute_time_t now = get_absolute_time();
+        rx->send_ack_eta((uint8_t)panel, sat16(eta_ms(panel, now)),
+                         sat16(s.model.predict(s.refresh_temp, s.sched.area_pct())));
     }
+    else
+    {
+        rx->send_ack_ok(rx_frame.panel);
+    }
+    rx->link().flush();
 
+    led_blink(1, 20);
+    exec.post(task_panels);
     return true;
 }
 
-static inline void send_ok()
+static void rx_task(void *)
 {
-    // Clean 2-byte ACK; no newline.
-    putchar_raw('O');
-    putchar_raw('K');
-    stdio_flush();
+    // At most one message per link per run, so a busy link cannot starve the other
+    bool more = false;
+    for (int i = 0; i < link_count; ++i)
+    {
+        Link &l = links[i];
+        if (l.dropped)
+        {
+            l.dropped = false;
+            l.rx->resync();
+        }
+        more |= receive(l);
+    }
+    if (more)
+        exec.post(task_rx);
 }
 
-static inline uint32_t u32le(const uint8_t b[4])
+// ---------------- SPI clock calibration ----------------
+// SPI_HZ_DEFAULT has to hold for every wire length. Instead, each rung below is
+// probed on every panel (write a test column at that clock, read it back slowly),
+// and the board runs one rung below the fastest that passed: the safety margin.
+// The result is stored in flash and re-checked every SPI_RECHECK_MS; a failing
+// re-check steps one rung down.
+static constexpr uint32_t SPI_HZ_LADDER[] = {8'000'000, 12'000'000, 16'000'000, 20'000'000,
+                                             25'000'000, 30'000'000, 37'500'000, 50'000'000};
+static constexpr int SPI_RUNGS = sizeof(SPI_HZ_LADDER) / sizeof(SPI_HZ_LADDER[0]);
+static constexpr int SPI_PROBE_PASSES = 3;
+static constexpr uint32_t SPI_RECHECK_MS = 10 * 60 * 1000;
+static constexpr uint32_t SPI_RECHECK_RETRY_MS = 1000;
+
+// What a stored calibration was measured with: panel geometry and count
+static constexpr uint32_t SPI_CAL_CONFIG = ((uint32_t)EPD::WIDTH << 16) ^ ((uint32_t)EPD::HEIGHT << 4) ^ PANEL_COUNT;
+
+static int spi_rung = -1; // in use; -1 = uncalibrated (SPI_HZ_DEFAULT)
+static int task_spi_check = -1;
+
+static bool probe_all(uint32_t hz, int passes)
 {
-    return (uint32_t)b[0] |
-           ((uint32_t)b[1] << 8) |
-           ((uint32_t)b[2] << 16) |
-           ((uint32_t)b[3] << 24);
+    for (int p = 0; p < passes; ++p)
+    {
+        for (int i = 0; i < PANEL_COUNT; ++i)
+        {
+            if (!slots[i].epd->probe_spi(hz))
+                return false;
+        }
+    }
+    return true;
 }
 
-int main()
+// One SPI instance for all panels, but each driver caches the rate for its own
+// probe and hardware sequencer divider
+static void set_spi_hz_all(uint32_t hz)
 {
-    stdio_init_all();
-    sleep_ms(1200); // let USB enumerate
+    for (int i = 0; i < PANEL_COUNT; ++i)
+        slots[i].epd->set_spi_hz(hz);
+}
 
-    const uint LED_PIN = 25;
-    gpio_init(LED_PIN);
-    gpio_set_dir(LED_PIN, GPIO_OUT);
-    gpio_put(LED_PIN, 0);
+static void use_spi_rung(int rung)
+{
+    spi_rung = rung;
+    set_spi_hz_all(SPI_HZ_LADDER[rung]);
+}
 
-    // Keep prints minimal. Anything you print can appear in the same stream the PC reads.
-    printf("mindwrite_epd_stream boot\n");
-    stdio_flush();
+static void save_spi_rung()
+{
+    Settings st;
+    st.spi_hz = SPI_HZ_LADDER[spi_rung];
+    st.config = SPI_CAL_CONFIG;
+    if (!Settings::save(st))
+        printf("W spi calibration not saved\n");
+}
 
-    // NOTE: match your driver constructor signature.
-    // If your header requires an extra bool, keep it. If not, remove it.
-    SSD1683_GDEY0579T93 epd(
-        spi0,
-        PIN_CS, PIN_DC, PIN_RST, PIN_BUSY,
-        PIN_SCK, PIN_MOSI,
-        true);
+// Boot: keep the stored clock if it still passes, otherwise sweep the ladder
+static void calibrate_spi()
+{
+    Settings st;
+    if (Settings::load(st) && st.config == SPI_CAL_CONFIG)
+    {
+        for (int r = 0; r < SPI_RUNGS; ++r)
+        {
+            if (SPI_HZ_LADDER[r] == st.spi_hz && probe_all(st.spi_hz, SPI_PROBE_PASSES))
+            {
+                use_spi_rung(r);
+                printf("N spi %lu Hz (stored)\n", (unsigned long)st.spi_hz);
+                return;
+            }
+        }
+    }
 
-    epd.init(SPI_HZ);
+    int fastest = -1;
+    while (fastest + 1 < SPI_RUNGS && probe_all(SPI_HZ_LADDER[fastest + 1], SPI_PROBE_PASSES))
+        ++fastest;
 
-    // Boot pattern once (proves display works independent of streaming)
-    static uint8_t boot_fb[FRAME_BYTES];
-    make_test_pattern(boot_fb);
-    epd.show_full_fullscreen(boot_fb);
-    blink_status(LED_PIN, 2, 80);
+    if (fastest < 0)
+    {
+        // Not even the slowest rung reads back: no usable readback on this board
+        set_spi_hz_all(SPI_HZ_DEFAULT);
+        printf("W spi probe failed, staying at %lu Hz\n", (unsigned long)SPI_HZ_DEFAULT);
+        return;
+    }
 
-    // Streaming buffer
-    static uint8_t frame[FRAME_BYTES];
+    use_spi_rung(fastest > 0 ? fastest - 1 : 0);
+    save_spi_rung();
+    printf("N spi %lu Hz (passed up to %lu)\n", (unsigned long)SPI_HZ_LADDER[spi_rung],
+           (unsigned long)SPI_HZ_LADDER[fastest]);
+}
 
-    // Parser state: sync on "MWF1"
-    uint8_t sync[4] = {0, 0, 0, 0};
+// Periodic re-validation; waits for a moment with no upload, refresh or readback
+static void spi_check_task(void *)
+{
+    bool idle = (bus_owner < 0 && suspended < 0);
+    for (int i = 0; i < PANEL_COUNT && idle; ++i)
+        idle = !slots[i].epd->busy() && slots[i].verify_next < 0;
+    if (!idle)
+    {
+        exec.post_in_ms(task_spi_check, SPI_RECHECK_RETRY_MS);
+        return;
+    }
 
-    while (true)
+    uint32_t hz = SPI_HZ_LADDER[spi_rung];
+    if (!probe_all(hz, 1) && spi_rung > 0)
+    {
+        use_spi_rung(spi_rung - 1);
+        save_spi_rung();
+        printf("W spi %lu Hz failed re-check, now %lu Hz\n", (unsigned long)hz,
+               (unsigned long)SPI_HZ_LADDER[spi_rung]);
+    }
+    else
     {
-        // Shift in bytes until we match "MWF1"
-        int c = getchar_timeout_us(1000);
-        if (c < 0)
+        use_spi_rung(spi_rung); // the probe may have left a different divider
+    }
+    exec.post_in_ms(task_spi_check, SPI_RECHECK_MS);
+}
+
+static void telemetry_task(void *)
+{
+    printf("T frames=%lu coalesced=%lu uploads=%lu upload_kb=%lu ram_bad=%lu recoveries=%lu\n",
+           (unsigned long)stats.frames, (unsigned long)stats.coalesced, (unsigned long)stats.uploads,
+           (unsigned long)(stats.upload_bytes / 1024), (unsigned long)stats.ram_bad, (unsigned long)sup.recoveries());
+    exec.post_in_ms(task_telemetry, MINDWRITE_TELEMETRY_MS);
+}
+
+static void link_attach_task(void *)
+{
+    for (int i = 0; i < link_count; ++i)
+    {
+        if (links[i].reattach)
         {
-            tight_loop_contents();
-            continue;
+            links[i].reattach = false;
+            links[i].t->attach();
         }
+    }
+}
 
-        sync[0] = sync[1];
-        sync[1] = sync[2];
-        sync[2] = sync[3];
-        sync[3] = (uint8_t)c;
+static void links_task(void *)
+{
+    for (int i = 0; i < link_count; ++i)
+        links[i].t->service();
+    exec.post_in_ms(task_links, LINK_SERVICE_MS);
+}
 
-        if (!(sync[0] == 'M' && sync[1] == 'W' && sync[2] == 'F' && sync[3] == '1'))
-            continue;
+// Panel i is wedged: reset the controller and queue its last frame again
+static void recover_panel(int i)
+{
+    PanelSlot &s = slots[i];
+    if (bus_owner == i)
+        bus_owner = -1;
+    if (suspended == i)
+        suspended = -1;
+    s.refreshing = false; // the reset cuts it short; not a sample
+    s.verify_next = -1;
 
-        // Read length (4), payload (len), crc (4)
-        uint8_t len_b[4];
-        if (!read_exact(len_b, 4, 2000))
-            continue;
+    sup.feed(); // the reset may wait on BUSY for a while
+    if (s.epd->reset(1000))
+        s.sched.damage(100, get_absolute_time()); // RAM was lost: full redraw of pending
+}
+
+static void supervise_task(void *)
+{
+    absolute_time_t now = get_absolute_time();
+
+    for (int i = 0; i < PANEL_COUNT; ++i)
+    {
+        PanelSlot &s = slots[i];
+        bool outstanding = (bus_owner == i || suspended == i || s.epd->busy());
+        sup.report(s.stage, outstanding, s.uploads != s.uploads_seen, now);
+        s.uploads_seen = s.uploads;
+    }
+
+    for (int i = 0; i < link_count; ++i)
+    {
+        Link &l = links[i];
+        uint32_t seen = l.rx->bytes_in();
+        sup.report(l.stage, l.rx->mid_message(), seen != l.bytes_seen, now);
+        l.bytes_seen = seen;
+    }
+
+    Supervisor::Action action;
+    int stage = sup.check(now, action);
+    if (stage >= 0)
+    {
+        printf("W stall=%s action=%s\n", sup.stage_name(stage), Supervisor::action_name(action));
+        stdio_flush();
 
-        uint32_t len = u32le(len_b);
-        if (len != (uint32_t)FRAME_BYTES)
+        switch (action)
         {
-            // wrong length -> drop frame, resync
-            continue;
+        case Supervisor::Action::PANEL_RESET:
+            for (int i = 0; i < PANEL_COUNT; ++i)
+            {
+                if (slots[i].stage == stage)
+                    recover_panel(i);
+            }
+            exec.post(task_panels);
+            break;
+
+        case Supervisor::Action::RESYNC:
+        case Supervisor::Action::RECONNECT:
+            for (int i = 0; i < link_count; ++i)
+            {
+                Link &l = links[i];
+                if (l.stage != stage)
+                    continue;
+
+                l.rx->resync();
+                if (action == Supervisor::Action::RECONNECT)
+                {
+                    // Re-attach after a pause so the host sees the link drop
+                    l.t->detach();
+                    l.reattach = true;
+                    exec.post_in_ms(task_link_attach, LINK_DETACH_MS);
+                }
+            }
+            break;
+
+        case Supervisor::Action::REBOOT:
+            sup.reboot(stage); // comes back up with the persisted frames
+            break;
+
+        default:
+            break;
         }
+    }
 
-        if (!read_exact(frame, FRAME_BYTES, 5000))
-            continue;
+    exec.post_in_ms(task_supervise, SUPERVISE_MS);
+}
 
-        uint8_t crc_b[4];
-        if (!read_exact(crc_b, 4, 2000))
-            continue;
+// ---------------- IRQ glue ----------------
+
+// Transport events (USB chars-available callback, lwIP callbacks: IRQ context)
+static void on_link_event(void *ctx, Transport &t, Transport::Event e)
+{
+    Link &l = *(Link *)ctx;
+    (void)t;
+
+    if (e == Transport::Event::DOWN)
+        l.dropped = true; // rx_task throws away the partial message
+    exec.post(task_rx);
+}
 
-        uint32_t want_crc = u32le(crc_b);
-        uint32_t got_crc = crc32_ieee(frame, FRAME_BYTES);
-        if (want_crc != got_crc)
+static void on_busy_edge(uint gpio, uint32_t events)
+{
+    (void)events;
+    for (int i = 0; i < PANEL_COUNT; ++i)
+    {
+        if (PANEL_PINS[i].busy == gpio)
+            slots[i].busy_release_us = time_us_64(); // refresh timing
+    }
+    exec.post(task_panels);
+}
+
+static void on_dma_irq()
+{
+    for (PanelSlot &s : slots)
+    {
+        uint ch = (uint)s.epd->dma_channel();
+        if (dma_channel_get_irq0_status(ch))
         {
-            // bad frame -> ignore, resync
-            blink_status(LED_PIN, 2, 40);
-            continue;
+            dma_channel_acknowledge_irq0(ch);
+            exec.post(task_panels);
         }
+    }
+}
+
+int main()
+{
+    // Read before the watchdog is re-armed (that overwrites the reason)
+    const int reboot_stage = Supervisor::last_reboot_stage();
+    const bool recovered = (reboot_stage != -2);
+
+    stdio_init_all();
+    sleep_ms(recovered ? 100 : 1200); // let USB enumerate; be quick after a recovery reboot
+
+#if !MINDWRITE_WIFI
+    gpio_init(PIN_LED);
+    gpio_set_dir(PIN_LED, GPIO_OUT);
+    gpio_put(PIN_LED, 0);
+#endif
+
+    adc_init();
+    adc_set_temp_sensor_enabled(true); // refresh timing is bucketed by temperature
+
+    // Keep prints minimal. Anything you print can appear in the same stream the PC reads.
+    printf("mindwrite_epd_stream boot\n");
+    if (recovered)
+        printf("W reboot stage=%d\n", reboot_stage);
+    stdio_flush();
 
-        // Full refresh (slow). When done, ACK OK so host paces itself.
-        epd.show_full_fullscreen(frame);
-        send_ok();
-        blink_status(LED_PIN, 1, 20);
+    BandDecoder::start(); // core 1: MWZ1 band decoding
+
+#if MINDWRITE_BENCH
+    kernel_bench_run();
+#endif
+
+    task_rx = exec.add(rx_task);
+    task_panels = exec.add(panels_task);
+    task_led = exec.add(led_task);
+    task_telemetry = exec.add(telemetry_task);
+    task_supervise = exec.add(supervise_task);
+    task_link_attach = exec.add(link_attach_task);
+    task_spi_check = exec.add(spi_check_task);
+
+    // Panel quirks (BUSY polarity, bit order, inversion) come from EPDPanel
+    for (int i = 0; i < PANEL_COUNT; ++i)
+    {
+        const PanelPins &p = PANEL_PINS[i];
+        slots[i].epd = new EPD(spi0, p.cs, p.dc, p.rst, p.busy, PIN_SCK, PIN_MOSI);
+        if (!slots[i].epd->init(SPI_HZ_DEFAULT))
+            printf("W panel %d: no BUSY release after reset\n", i);
+        slots[i].epd->set_slice_bytes(UPLOAD_SLICE_BYTES);
+        if (MINDWRITE_HW_SEQUENCE && !slots[i].epd->enable_hw_sequence())
+            printf("W panel %d: no hardware sequencer, uploads stay on the CPU\n", i);
+        slots[i].shown = &persisted[i].frame;
+        slots[i].stage = sup.add_stage("panel", PANEL_STALL_MS, Supervisor::Action::PANEL_RESET,
+                                       Supervisor::Action::PANEL_RESET, Supervisor::Action::REBOOT);
+    }
+    task_links = exec.add(links_task);
+    calibrate_spi();
+
+    usb_link.begin();
+    links[link_count++].t = &usb_link;
+#if MINDWRITE_WIFI
+    if (net_link.begin(MINDWRITE_WIFI_SSID, MINDWRITE_WIFI_PASSWORD))
+        links[link_count++].t = &net_link;
+    else
+        printf("N radio init failed\n");
+#endif
+
+    for (int i = 0; i < link_count; ++i)
+    {
+        Link &l = links[i];
+        l.rx = new FrameReceiver(*l.t, FRAME_BYTES, rx_buf[i]);
+        l.t->set_listener(on_link_event, &l);
+        l.stage = sup.add_stage(l.t->name(), RX_STALL_MS, Supervisor::Action::RESYNC,
+                                Supervisor::Action::RECONNECT, Supervisor::Action::REBOOT);
+    }
+
+    // Wake-ups: BUSY released, upload DMA finished, USB data arrived
+    const uint32_t idle_edge = EPDPanel::BUSY_ACTIVE_HIGH ? GPIO_IRQ_EDGE_FALL : GPIO_IRQ_EDGE_RISE;
+    gpio_set_irq_enabled_with_callback(PANEL_PINS[0].busy, idle_edge, true, on_busy_edge);
+    for (int i = 1; i < PANEL_COUNT; ++i)
+        gpio_set_irq_enabled(PANEL_PINS[i].busy, idle_edge, true);
+
+    irq_add_shared_handler(DMA_IRQ_0, on_dma_irq, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+    for (PanelSlot &s : slots)
+        dma_channel_set_irq0_enabled((uint)s.epd->dma_channel(), true);
+    irq_set_enabled(DMA_IRQ_0, true);
+
+    // After a recovery reboot, put back what each panel showed. Otherwise the boot
+    // pattern (proves display works independent of streaming). Drawn straight into
+    // controller order; all panels refresh in parallel.
+    for (int i = 0; i < PANEL_COUNT; ++i)
+    {
+        PanelSlot &s = slots[i];
+        if (recovered && persist_valid(persisted[i]))
+        {
+            memcpy(&s.pending, s.shown, sizeof(EPDFrame));
+        }
+        else
+        {
+            persisted[i].magic = 0;
+            s.shown->clear(true);
+            make_test_pattern(s.pending);
+        }
+        s.sched.damage(100, get_absolute_time()); // glass contents unknown: full redraw
     }
+    exec.post(task_panels);
+    exec.post(task_rx);
+    exec.post(task_links);
+    led_blink(2, 80);
+
+    if (MINDWRITE_TELEMETRY_MS > 0)
+        exec.post_in_ms(task_telemetry, MINDWRITE_TELEMETRY_MS);
+    if (spi_rung >= 0)
+        exec.post_in_ms(task_spi_check, SPI_RECHECK_MS);
+
+    sup.start_watchdog(WATCHDOG_MS);
+    exec.post_in_ms(task_supervise, SUPERVISE_MS);
+
+    exec.run();
 }
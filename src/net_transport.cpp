@@ -0,0 +1,222 @@
+#include "net_transport.h"
+
+#include <cstdio>
+#include <cstring>
+
+#include "pico/cyw43_arch.h"
+#include "lwip/tcp.h"
+
+NetTransport::NetTransport(uint16_t port)
+    : port_(port) {}
+
+bool NetTransport::begin(const char *ssid, const char *password)
+{
+    if (cyw43_arch_init() != 0)
+        return false;
+    radio_ready_ = true;
+
+    cyw43_arch_enable_sta_mode();
+    cyw43_wifi_pm(&cyw43_state, CYW43_NONE_PM); // latency over power: frames arrive in bursts
+    return cyw43_arch_wifi_connect_async(ssid, password, CYW43_AUTH_WPA2_AES_PSK) == 0;
+}
+
+void NetTransport::service()
+{
+    bool up = cyw43_tcpip_link_status(&cyw43_state, CYW43_ITF_STA) == CYW43_LINK_UP;
+    if (up == link_up_)
+        return;
+    link_up_ = up;
+
+    if (!up)
+    {
+        printf("N link down\n");
+        return;
+    }
+
+    printf("N up %s:%u\n", ip4addr_ntoa(netif_ip4_addr(netif_list)), port_);
+    if (listen_)
+        return;
+
+    cyw43_arch_lwip_begin();
+    tcp_pcb *pcb = tcp_new_ip_type(IPADDR_TYPE_ANY);
+    if (pcb && tcp_bind(pcb, IP_ANY_TYPE, port_) == ERR_OK)
+    {
+        listen_ = tcp_listen_with_backlog(pcb, 1);
+        tcp_arg(listen_, this);
+        tcp_accept(listen_, on_accept_);
+    }
+    else if (pcb)
+    {
+        tcp_abort(pcb);
+    }
+    cyw43_arch_lwip_end();
+}
+
+int8_t NetTransport::on_accept_(void *arg, tcp_pcb *pcb, int8_t err)
+{
+    NetTransport *self = (NetTransport *)arg;
+    if (err != ERR_OK || !pcb)
+        return ERR_VAL;
+
+    // Newest host wins (e.g. after the old one vanished without a FIN)
+    if (self->client_)
+        self->close_client_();
+
+    self->client_ = pcb;
+    tcp_arg(pcb, self);
+    tcp_recv(pcb, on_recv_);
+    tcp_err(pcb, on_err_);
+    tcp_nagle_disable(pcb); // ACKs are tiny and latency-bound
+    self->notify_(Event::UP);
+    return ERR_OK;
+}
+
+int8_t NetTransport::on_recv_(void *arg, tcp_pcb *pcb, pbuf *p, int8_t err)
+{
+    NetTransport *self = (NetTransport *)arg;
+    (void)err;
+
+    if (!p)
+    {
+        // Peer closed; lwIP must not touch the pcb again if it was aborted
+        if (pcb == self->client_ && self->close_client_())
+            return ERR_ABRT;
+        return ERR_OK;
+    }
+
+    if (self->rx_)
+        pbuf_cat(self->rx_, p);
+    else
+        self->rx_ = p;
+
+    self->notify_(Event::DATA);
+    return ERR_OK;
+}
+
+void NetTransport::on_err_(void *arg, int8_t err)
+{
+    NetTransport *self = (NetTransport *)arg;
+    (void)err;
+
+    // lwIP has already freed the pcb
+    self->client_ = nullptr;
+    self->drop_rx_();
+    self->notify_(Event::DOWN);
+}
+
+bool NetTransport::close_client_()
+{
+    tcp_arg(client_, nullptr);
+    tcp_recv(client_, nullptr);
+    tcp_err(client_, nullptr);
+    bool aborted = false;
+    if (tcp_close(client_) != ERR_OK)
+    {
+        tcp_abort(client_);
+        aborted = true;
+    }
+    client_ = nullptr;
+
+    drop_rx_();
+    notify_(Event::DOWN);
+    return aborted;
+}
+
+// Unread data of a closed connection: the main loop may still be reading the head
+// it peeked, so the chain is only parked here (lwIP context or under its lock)
+void NetTransport::drop_rx_()
+{
+    if (rx_)
+    {
+        if (dropped_)
+            pbuf_cat(dropped_, rx_);
+        else
+            dropped_ = rx_;
+        rx_ = nullptr;
+        rx_off_ = 0;
+    }
+    ++gen_;
+}
+
+const uint8_t *NetTransport::peek(size_t &n)
+{
+    // The previous peek's bytes are consumed by now, so parked chains can go. The
+    // head stays valid until consume(): callbacks append behind it or park it.
+    cyw43_arch_lwip_begin();
+    if (dropped_)
+    {
+        pbuf_free(dropped_);
+        dropped_ = nullptr;
+    }
+    pbuf *head = rx_;
+    peek_gen_ = gen_;
+    cyw43_arch_lwip_end();
+
+    if (!head)
+    {
+        n = 0;
+        return nullptr;
+    }
+    n = head->len - rx_off_;
+    return (const uint8_t *)head->payload + rx_off_;
+}
+
+void NetTransport::consume(size_t n)
+{
+    cyw43_arch_lwip_begin();
+    if (gen_ != peek_gen_)
+    {
+        // The peeked bytes went with their connection; rx_ (if any) is a new one's
+        cyw43_arch_lwip_end();
+        return;
+    }
+
+    size_t left = n;
+    while (rx_ && left > 0)
+    {
+        uint16_t avail = (uint16_t)(rx_->len - rx_off_);
+        uint16_t take = (left < avail) ? (uint16_t)left : avail;
+        rx_off_ = (uint16_t)(rx_off_ + take);
+        left -= take;
+
+        if (rx_off_ == rx_->len)
+        {
+            // Head pbuf fully read: unlink it and free its memory
+            pbuf *next = rx_->next;
+            if (next)
+                pbuf_ref(next);
+            pbuf_free(rx_);
+            rx_ = next;
+            rx_off_ = 0;
+        }
+    }
+
+    // Reopen the receive window by what was actually read (the credit)
+    if (n > 0 && client_)
+        tcp_recved(client_, (uint16_t)n);
+    cyw43_arch_lwip_end();
+}
+
+void NetTransport::write(const uint8_t *src, size_t n)
+{
+    cyw43_arch_lwip_begin();
+    if (client_)
+        tcp_write(client_, src, (uint16_t)n, TCP_WRITE_FLAG_COPY);
+    cyw43_arch_lwip_end();
+}
+
+void NetTransport::flush()
+{
+    cyw43_arch_lwip_begin();
+    if (client_)
+        tcp_output(client_);
+    cyw43_arch_lwip_end();
+}
+
+void NetTransport::detach()
+{
+    cyw43_arch_lwip_begin();
+    if (client_)
+        close_client_();
+    cyw43_arch_lwip_end();
+}
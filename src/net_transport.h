@@ -0,0 +1,70 @@
+#pragma once
+#include <cstdint>
+
+#include "transport.h"
+
+struct tcp_pcb;
+struct pbuf;
+
+// Frame protocol over TCP on the pico2_w radio (cyw43 + lwIP, threadsafe_background).
+//
+// One client at a time. TCP gives the ordering and retransmission the USB link
+// gets for free, and its receive window is the credit: received pbufs are only
+// acknowledged to lwIP (tcp_recved) once read() has consumed them, so a host
+// streaming faster than the panels refresh is throttled by the window rather
+// than by dropped data. peek() hands out the head pbuf's payload in place.
+// lwIP callbacks run in a low-priority IRQ, so the listener's UP/DOWN/DATA
+// events arrive from there. A callback that ends the connection may preempt the
+// main loop between peek() and consume(), so it never frees the chain: it parks
+// it in dropped_ and bumps gen_, and the main loop frees it on the next peek().
+class NetTransport : public Transport
+{
+public:
+    explicit NetTransport(uint16_t port);
+
+    // Bring up the radio and start joining; the listener opens once the link is up
+    bool begin(const char *ssid, const char *password);
+
+    // cyw43 is initialised (its GPIOs, e.g. the LED, can be driven)
+    bool radio_ready() const { return radio_ready_; }
+
+    // Main-loop housekeeping: watch the Wi-Fi link, open the listener. Cheap.
+    void service() override;
+
+    const char *name() const override { return "net"; }
+
+    const uint8_t *peek(size_t &n) override;
+    void consume(size_t n) override;
+
+    void write(const uint8_t *src, size_t n) override;
+    void flush() override;
+    bool connected() const override { return client_ != nullptr; }
+
+    // Drops the current client; the host reconnects
+    void detach() override;
+
+private:
+    uint16_t port_;
+
+    bool radio_ready_ = false;
+    bool link_up_ = false;
+    tcp_pcb *listen_ = nullptr;
+    tcp_pcb *client_ = nullptr;
+
+    // Received but not yet read; consumed from the head
+    pbuf *rx_ = nullptr;
+    uint16_t rx_off_ = 0;
+
+    // Chains of closed connections, freed by the main loop
+    pbuf *dropped_ = nullptr;
+    uint32_t gen_ = 0;      // bumped whenever rx_ is dropped
+    uint32_t peek_gen_ = 0; // gen_ at the last peek()
+
+    // True when the pcb had to be aborted (a callback on it must return ERR_ABRT)
+    bool close_client_();
+    void drop_rx_();
+
+    static int8_t on_accept_(void *arg, tcp_pcb *pcb, int8_t err);
+    static int8_t on_recv_(void *arg, tcp_pcb *pcb, pbuf *p, int8_t err);
+    static void on_err_(void *arg, int8_t err);
+};
@@ -0,0 +1,54 @@
+#include "refresh_model.h"
+
+int RefreshModel::temp_band_(int temp_c)
+{
+    int b = temp_c < 0 ? 0 : temp_c / 10;
+    return b >= TEMP_BANDS ? TEMP_BANDS - 1 : b;
+}
+
+int RefreshModel::area_band_(uint8_t area_pct)
+{
+    int b = area_pct * AREA_BANDS / 101; // 0-25, 26-50, 51-75, 76-100
+    return b >= AREA_BANDS ? AREA_BANDS - 1 : b;
+}
+
+void RefreshModel::record(int temp_c, uint8_t area_pct, uint32_t busy_ms)
+{
+    Cell &c = cells_[temp_band_(temp_c)][area_band_(area_pct)];
+
+    // First sample is taken as is, then weight 1/4 so drift is followed within a few refreshes
+    if (c.n == 0)
+        c.mean_ms = busy_ms;
+    else
+        c.mean_ms = (uint32_t)((int32_t)c.mean_ms + ((int32_t)busy_ms - (int32_t)c.mean_ms) / 4);
+
+    if (c.n < UINT16_MAX)
+        c.n++;
+    samples_++;
+}
+
+uint32_t RefreshModel::predict(int temp_c, uint8_t area_pct) const
+{
+    const int t = temp_band_(temp_c);
+    const int a = area_band_(area_pct);
+
+    // Nearest populated bucket; a temperature band away costs more than an area band
+    int best = -1;
+    uint32_t ms = DEFAULT_MS;
+    for (int i = 0; i < TEMP_BANDS; ++i)
+    {
+        for (int j = 0; j < AREA_BANDS; ++j)
+        {
+            if (cells_[i][j].n == 0)
+                continue;
+
+            int d = 2 * (i > t ? i - t : t - i) + (j > a ? j - a : a - j);
+            if (best < 0 || d < best)
+            {
+                best = d;
+                ms = cells_[i][j].mean_ms;
+            }
+        }
+    }
+    return ms;
+}
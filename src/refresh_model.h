@@ -0,0 +1,36 @@
+#pragma once
+#include <cstdint>
+
+// Running estimate of how long a refresh keeps the panel BUSY, so the host can
+// pace its submissions instead of guessing.
+//
+// Durations are measured per update mode (only full refreshes exist so far, so
+// one model per panel) and bucketed by temperature, where the waveform tables
+// change, and by damaged area. Each bucket keeps an exponentially weighted mean;
+// an empty bucket borrows from the nearest one that has samples, temperature
+// first, and falls back to DEFAULT_MS before the first refresh.
+class RefreshModel
+{
+public:
+    static constexpr int TEMP_BANDS = 5; // < 10, < 20, < 30, < 40, >= 40 C
+    static constexpr int AREA_BANDS = 4; // quarters of the panel
+    static constexpr uint32_t DEFAULT_MS = 3000;
+
+    void record(int temp_c, uint8_t area_pct, uint32_t busy_ms);
+    uint32_t predict(int temp_c, uint8_t area_pct) const;
+
+    uint32_t samples() const { return samples_; }
+
+private:
+    struct Cell
+    {
+        uint32_t mean_ms = 0;
+        uint16_t n = 0;
+    };
+
+    Cell cells_[TEMP_BANDS][AREA_BANDS];
+    uint32_t samples_ = 0;
+
+    static int temp_band_(int temp_c);
+    static int area_band_(uint8_t area_pct);
+};
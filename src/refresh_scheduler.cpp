@@ -0,0 +1,80 @@
+#include "refresh_scheduler.h"
+
+void RefreshScheduler::damage(uint8_t area_pct, absolute_time_t now, Lane lane)
+{
+    if (area_pct == 0)
+    {
+        committed(); // changed back to what is shown
+        return;
+    }
+
+    if (!dirty_)
+    {
+        first_ = now;
+        interactive_ = false;
+    }
+    if (lane == Lane::INTERACTIVE)
+        interactive_ = true;
+    dirty_ = true;
+    last_ = now;
+    area_pct_ = area_pct;
+}
+
+RefreshScheduler::Reason RefreshScheduler::decide(bool panel_idle, absolute_time_t now, absolute_time_t &wake) const
+{
+    wake = at_the_end_of_time;
+    if (!dirty_)
+        return Reason::NONE;
+
+    absolute_time_t deadline = delayed_by_ms(first_, policy_.deadline_ms);
+    absolute_time_t quiet = delayed_by_ms(last_, policy_.quiet_ms);
+
+    Reason r = Reason::NONE;
+    if (interactive_)
+        r = Reason::INTERACTIVE;
+    else if (policy_.deadline_ms == 0 || absolute_time_diff_us(deadline, now) >= 0)
+        r = Reason::DEADLINE;
+    else if (area_pct_ >= policy_.big_area_pct)
+        r = Reason::BIG;
+    else if (policy_.quiet_ms > 0 && absolute_time_diff_us(quiet, now) >= 0)
+        r = Reason::QUIET;
+
+    if (r == Reason::NONE)
+    {
+        // Earliest of the two timers; BUSY release is signalled separately
+        wake = (policy_.quiet_ms > 0 && absolute_time_diff_us(quiet, deadline) > 0) ? quiet : deadline;
+        return Reason::NONE;
+    }
+
+    // Ready, but the panel is still refreshing the previous frame
+    return panel_idle ? r : Reason::NONE;
+}
+
+void RefreshScheduler::committed()
+{
+    dirty_ = false;
+    interactive_ = false;
+    area_pct_ = 0;
+}
+
+uint32_t RefreshScheduler::age_ms(absolute_time_t now) const
+{
+    return dirty_ ? (uint32_t)(absolute_time_diff_us(first_, now) / 1000) : 0;
+}
+
+const char *RefreshScheduler::reason_name(Reason r)
+{
+    switch (r)
+    {
+    case Reason::INTERACTIVE:
+        return "interactive";
+    case Reason::BIG:
+        return "big";
+    case Reason::QUIET:
+        return "quiet";
+    case Reason::DEADLINE:
+        return "deadline";
+    default:
+        return "none";
+    }
+}
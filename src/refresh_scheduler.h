@@ -0,0 +1,78 @@
+#pragma once
+#include <cstdint>
+
+#include "pico/stdlib.h"
+
+// Decides when a panel's accumulated damage is committed as a refresh.
+//
+// Frames that arrive while a refresh is running (or shortly after the first
+// change) are merged into the panel's pending frame; the scheduler only tracks
+// when damage started, when it last changed and how much of the glass it covers.
+// A refresh is committed once the panel is idle and one of these holds:
+//
+//   BIG      damage covers at least big_area_pct of the panel: the whole glass
+//            flashes anyway, waiting buys nothing
+//   QUIET    no new damage for quiet_ms (the burst of updates is over)
+//   DEADLINE deadline_ms have passed since the first damage
+//
+// INTERACTIVE damage (caret, typed glyph: see Lane) skips all of that and commits
+// as soon as the panel is idle.
+//
+// With deadline_ms = 0 every damage is committed as soon as the panel is idle.
+// Only full refreshes exist, so there is no ghosting budget to spend yet.
+class RefreshScheduler
+{
+public:
+    struct Policy
+    {
+        uint16_t deadline_ms = 30;
+        uint16_t quiet_ms = 10;
+        uint8_t big_area_pct = 50;
+        bool trace = false;
+    };
+
+    // Priority class of an update
+    enum class Lane : uint8_t
+    {
+        BACKGROUND = 0, // full frames, repaints: coalesced under the policy
+        INTERACTIVE = 1 // small latency-critical rects
+    };
+
+    enum class Reason : uint8_t
+    {
+        NONE,
+        INTERACTIVE,
+        BIG,
+        QUIET,
+        DEADLINE,
+    };
+
+    void set_policy(const Policy &p) { policy_ = p; }
+    const Policy &policy() const { return policy_; }
+
+    // Damage (pending vs. shown) now covers area_pct percent of the panel. 0 means
+    // the pending frame equals what is on the glass: nothing left to refresh.
+    void damage(uint8_t area_pct, absolute_time_t now, Lane lane = Lane::BACKGROUND);
+
+    // Should the refresh start now? panel_idle = not BUSY and the bus is free.
+    // When not, wake is set to the next time the answer may change.
+    Reason decide(bool panel_idle, absolute_time_t now, absolute_time_t &wake) const;
+
+    // The pending frame has been handed to the panel
+    void committed();
+
+    bool dirty() const { return dirty_; }
+    bool interactive() const { return dirty_ && interactive_; }
+    uint8_t area_pct() const { return area_pct_; }
+    uint32_t age_ms(absolute_time_t now) const;
+
+    static const char *reason_name(Reason r);
+
+private:
+    Policy policy_;
+    bool dirty_ = false;
+    bool interactive_ = false;
+    uint8_t area_pct_ = 0;
+    absolute_time_t first_ = 0;
+    absolute_time_t last_ = 0;
+};
@@ -0,0 +1,57 @@
+#include "settings.h"
+
+#include <cstring>
+
+#include "hardware/flash.h"
+#include "pico/flash.h"
+
+#include "crc32.h"
+
+static constexpr uint32_t SETTINGS_MAGIC = 0x4D575354u; // "MWST"
+static constexpr uint32_t SETTINGS_VERSION = 1;
+static constexpr uint32_t SETTINGS_OFFSET = PICO_FLASH_SIZE_BYTES - FLASH_SECTOR_SIZE;
+
+struct Record
+{
+    uint32_t magic;
+    uint32_t version;
+    Settings s;
+    uint32_t crc; // of s
+};
+
+bool Settings::load(Settings &out)
+{
+    Record r;
+    memcpy(&r, (const void *)(XIP_BASE + SETTINGS_OFFSET), sizeof(r));
+
+    if (r.magic != SETTINGS_MAGIC || r.version != SETTINGS_VERSION ||
+        r.crc != crc32_compute((const uint8_t *)&r.s, sizeof(r.s)))
+        return false;
+
+    out = r.s;
+    return true;
+}
+
+// Runs with interrupts off (flash_safe_execute); XIP is unavailable meanwhile
+static void program_sector(void *param)
+{
+    flash_range_erase(SETTINGS_OFFSET, FLASH_SECTOR_SIZE);
+    flash_range_program(SETTINGS_OFFSET, (const uint8_t *)param, FLASH_PAGE_SIZE);
+}
+
+bool Settings::save(const Settings &s)
+{
+    static_assert(sizeof(Record) <= FLASH_PAGE_SIZE, "settings record must fit one page");
+
+    alignas(4) static uint8_t page[FLASH_PAGE_SIZE];
+    memset(page, 0xFF, sizeof(page));
+
+    Record r;
+    r.magic = SETTINGS_MAGIC;
+    r.version = SETTINGS_VERSION;
+    r.s = s;
+    r.crc = crc32_compute((const uint8_t *)&r.s, sizeof(r.s));
+    memcpy(page, &r, sizeof(r));
+
+    return flash_safe_execute(program_sector, page, 100) == PICO_OK;
+}
@@ -0,0 +1,17 @@
+#pragma once
+#include <cstdint>
+
+// Board settings kept in the last flash sector, so they survive power cycles and
+// reflashing. Only values measured on this unit live here (e.g. the calibrated SPI
+// clock); anything the host sends again after connecting is not persisted.
+struct Settings
+{
+    uint32_t spi_hz = 0; // calibrated panel SPI clock, 0 = not calibrated
+    uint32_t config = 0; // fingerprint of the build the values were measured with
+
+    // False when the sector holds no valid record
+    static bool load(Settings &out);
+
+    // Erase and program the sector; interrupts are off for a few tens of ms
+    static bool save(const Settings &s);
+};
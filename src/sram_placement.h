@@ -0,0 +1,39 @@
+#pragma once
+
+#include "pico.h"
+
+// Where the per-frame hot paths live (MINDWRITE_SRAM_PLACEMENT).
+//
+//   MW_RAM_FUNC(name)    a function runs from SRAM instead of XIP flash, so a cache
+//   MW_RAM_CODE("grp")   miss (e.g. after a settings write to flash) never stalls it.
+//                        MW_RAM_CODE is the attribute form, for members and templates.
+//                        Both are noinline: inlined into a flash caller, the loop
+//                        would run from flash again. GCC drops section attributes
+//                        on template instances, so template kernels get a plain
+//                        MW_RAM_FUNC wrapper marked flatten, which pulls them in.
+//   MW_SCRATCH_X("grp")  small CPU-only tables go to a scratch bank (SRAM8/9), off the
+//   MW_SCRATCH_Y("grp")  main SRAM that the frame buffers and upload DMA use.
+//
+// Frame and staging buffers stay in main SRAM on purpose. SRAM0-7 is word-striped,
+// so any buffer is already spread over all eight banks and a DMA burst out of one
+// plane and a CPU pass over another rarely hit the same bank in the same cycle.
+//
+// The scratch banks are 4 KB each and also hold the stacks (core 0 in Y, core 1 in
+// X, 2 KB each), so only tables of a few hundred bytes to ~1 KB belong there.
+//
+// OFF leaves everything where the linker puts it, for A/B runs of kernel_bench.
+#ifndef MINDWRITE_SRAM_PLACEMENT
+#define MINDWRITE_SRAM_PLACEMENT 0
+#endif
+
+#if MINDWRITE_SRAM_PLACEMENT
+#define MW_RAM_FUNC(name) __no_inline_not_in_flash_func(name)
+#define MW_RAM_CODE(group) __noinline __not_in_flash(group)
+#define MW_SCRATCH_X(group) __scratch_x(group)
+#define MW_SCRATCH_Y(group) __scratch_y(group)
+#else
+#define MW_RAM_FUNC(name) name
+#define MW_RAM_CODE(group)
+#define MW_SCRATCH_X(group)
+#define MW_SCRATCH_Y(group)
+#endif
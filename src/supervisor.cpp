@@ -0,0 +1,105 @@
+#include "supervisor.h"
+
+#include "hardware/watchdog.h"
+
+// watchdog scratch[0..3] are free for the application (the SDK uses 4..7)
+static constexpr uint32_t REBOOT_MAGIC = 0x4D575344u; // "MWSD"
+
+int Supervisor::add_stage(const char *name, uint32_t stall_ms, Action a0, Action a1, Action a2)
+{
+    if (count_ >= MAX_STAGES)
+        return -1;
+
+    Stage &s = stages_[count_];
+    s.name = name;
+    s.stall_ms = stall_ms;
+    s.ladder[0] = a0;
+    s.ladder[1] = a1;
+    s.ladder[2] = a2;
+    return count_++;
+}
+
+void Supervisor::report(int id, bool outstanding, bool progressed, absolute_time_t now)
+{
+    Stage &s = stages_[id];
+
+    if (!outstanding)
+    {
+        if (s.outstanding)
+            s.rung = 0; // finished normally: healthy again
+        s.outstanding = false;
+        return;
+    }
+
+    if (!s.outstanding || progressed)
+        s.since = now;
+    s.outstanding = true;
+}
+
+int Supervisor::check(absolute_time_t now, Action &action)
+{
+    feed();
+
+    action = Action::NONE;
+    for (int i = 0; i < count_; ++i)
+    {
+        Stage &s = stages_[i];
+        if (!s.outstanding || absolute_time_diff_us(s.since, now) < (int64_t)s.stall_ms * 1000)
+            continue;
+
+        action = s.ladder[s.rung];
+        if (s.rung + 1 < LADDER)
+            ++s.rung;
+        s.since = now; // give the recovery a full threshold before the next rung
+        ++recoveries_;
+        return i;
+    }
+    return -1;
+}
+
+void Supervisor::start_watchdog(uint32_t timeout_ms)
+{
+    watchdog_enable(timeout_ms, true); // paused while a debugger halts the core
+    watchdog_hw->scratch[0] = REBOOT_MAGIC;
+    watchdog_hw->scratch[1] = (uint32_t)-1; // a bare timeout means the loop hung
+    watchdog_ = true;
+}
+
+void Supervisor::feed()
+{
+    if (watchdog_)
+        watchdog_update();
+}
+
+void Supervisor::reboot(int stage)
+{
+    watchdog_hw->scratch[0] = REBOOT_MAGIC;
+    watchdog_hw->scratch[1] = (uint32_t)stage;
+    watchdog_reboot(0, 0, 0);
+    while (true)
+        tight_loop_contents();
+}
+
+int Supervisor::last_reboot_stage()
+{
+    if (!watchdog_caused_reboot() || watchdog_hw->scratch[0] != REBOOT_MAGIC)
+        return -2;
+    return (int)watchdog_hw->scratch[1];
+}
+
+const char *Supervisor::action_name(Action a)
+{
+    switch (a)
+    {
+    case Action::RESYNC:
+        return "resync";
+    case Action::PANEL_RESET:
+        return "panel_reset";
+    case Action::RECONNECT:
+        return "reconnect";
+    case Action::REBOOT:
+        return "reboot";
+    default:
+        return "none";
+    }
+}
@@ -0,0 +1,74 @@
+#pragma once
+#include <cstdint>
+
+#include "pico/stdlib.h"
+
+// Stall detection for the pipeline stages plus the hardware watchdog.
+//
+// Each stage reports, from a periodic check, whether it has work outstanding and
+// whether it made progress since the last report. A stage that stays outstanding
+// without progress for longer than its threshold has stalled; check() then hands
+// back the next rung of that stage's recovery ladder, e.g.
+//
+//   panel: PANEL_RESET -> PANEL_RESET -> REBOOT
+//   link:  RESYNC -> RECONNECT -> REBOOT
+//
+// A stage that completes its work normally starts again from the bottom rung.
+// The hardware watchdog is fed only from check(), so a wedged main loop (or a
+// blocking call that never returns) reboots the board on its own.
+class Supervisor
+{
+public:
+    static constexpr int MAX_STAGES = 8;
+    static constexpr int LADDER = 3;
+
+    enum class Action : uint8_t
+    {
+        NONE,
+        RESYNC,        // drop partial state in the stage itself
+        PANEL_RESET,   // hardware reset + re-init of the panel controller
+        RECONNECT,     // drop and re-establish the link (USB detach, TCP client)
+        REBOOT,
+    };
+
+    // Register a stage; returns its id (or -1 when full)
+    int add_stage(const char *name, uint32_t stall_ms, Action a0, Action a1, Action a2);
+
+    // outstanding = stage has work in flight; progressed = it moved since last time
+    void report(int id, bool outstanding, bool progressed, absolute_time_t now);
+
+    // Feed the watchdog and return the first stalled stage (-1 if none) and what to do
+    int check(absolute_time_t now, Action &action);
+
+    // Hardware watchdog; reboots if check() is not called for timeout_ms
+    void start_watchdog(uint32_t timeout_ms);
+    void feed();
+
+    // Reboot now, remembering which stage caused it (see last_reboot_stage)
+    [[noreturn]] void reboot(int stage);
+
+    // After a supervisor/watchdog reboot: stage that triggered it, -1 for a hang of
+    // the whole loop. -2 when this was a normal power-on or reset.
+    static int last_reboot_stage();
+
+    const char *stage_name(int id) const { return stages_[id].name; }
+    uint32_t recoveries() const { return recoveries_; }
+
+    static const char *action_name(Action a);
+
+private:
+    struct Stage
+    {
+        const char *name = nullptr;
+        uint32_t stall_ms = 0;
+        Action ladder[LADDER] = {};
+        bool outstanding = false;
+        absolute_time_t since = 0; // start of work or last progress
+        uint8_t rung = 0;
+    };
+
+    Stage stages_[MAX_STAGES];
+    int count_ = 0;
+    uint32_t recoveries_ = 0;
+    bool watchdog_ = false;
+};
@@ -0,0 +1,22 @@
+#include "transport.h"
+
+#include <cstring>
+
+size_t Transport::read(uint8_t *dst, size_t max)
+{
+    size_t got = 0;
+    while (got < max)
+    {
+        size_t n;
+        const uint8_t *p = peek(n);
+        if (n == 0)
+            break;
+        if (n > max - got)
+            n = max - got;
+
+        memcpy(dst + got, p, n);
+        consume(n);
+        got += n;
+    }
+    return got;
+}
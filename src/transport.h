@@ -0,0 +1,76 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// Link the frame protocol runs over (USB CDC, TCP, an in-memory recording, ...).
+//
+// Reads are chunked and zero-copy: peek() exposes the backend's own buffer (a
+// USB staging block, an lwIP pbuf, a recording in flash) and consume() releases
+// it. read() is the one-copy path for bulk payloads: backends that must copy
+// anyway (USB FIFO) copy straight into the caller's frame buffer.
+//
+// Link changes and arriving data are reported through the listener, possibly from
+// IRQ context, so the owner can post a task. All other calls are main-loop only.
+class Transport
+{
+public:
+    enum class Event : uint8_t
+    {
+        UP,   // peer attached (USB host opened the port, TCP client connected)
+        DOWN, // peer gone: a partial message will never complete
+        DATA, // new bytes can be peeked
+    };
+    using Listener = void (*)(void *ctx, Transport &t, Event e);
+
+    virtual ~Transport() = default;
+
+    virtual const char *name() const = 0;
+
+    void set_listener(Listener fn, void *ctx)
+    {
+        listener_ = fn;
+        listener_ctx_ = ctx;
+    }
+
+    // Oldest unread bytes as one contiguous run (n = 0 when empty); valid until consume()
+    virtual const uint8_t *peek(size_t &n) = 0;
+    virtual void consume(size_t n) = 0;
+
+    // Copy up to max bytes into dst; returns the count
+    virtual size_t read(uint8_t *dst, size_t max);
+
+    // Queue bytes for the peer (the protocol only sends short ACKs)
+    virtual void write(const uint8_t *src, size_t n) = 0;
+    virtual void flush() {}
+
+    virtual bool connected() const = 0;
+
+    // Periodic housekeeping from the main loop (link state polling and the like)
+    virtual void service() {}
+
+    // Recovery: drop the link, then bring it back (attach() may follow a delay)
+    virtual void detach() {}
+    virtual void attach() {}
+
+protected:
+    void notify_(Event e)
+    {
+        if (listener_)
+            listener_(listener_ctx_, *this, e);
+    }
+
+    // For backends that learn link state by polling: emits UP/DOWN on changes
+    void track_link_(bool up)
+    {
+        if (up != link_up_)
+        {
+            link_up_ = up;
+            notify_(up ? Event::UP : Event::DOWN);
+        }
+    }
+
+private:
+    Listener listener_ = nullptr;
+    void *listener_ctx_ = nullptr;
+    bool link_up_ = false;
+};
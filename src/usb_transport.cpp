@@ -0,0 +1,86 @@
+#include "usb_transport.h"
+
+#include <cstring>
+
+#include "pico/stdlib.h"
+#include "pico/stdio_usb.h"
+#include "tusb.h"
+
+void UsbTransport::begin()
+{
+    stdio_set_chars_available_callback(on_chars_, this);
+}
+
+void UsbTransport::on_chars_(void *ctx)
+{
+    ((UsbTransport *)ctx)->notify_(Event::DATA);
+}
+
+size_t UsbTransport::fifo_read_(uint8_t *dst, size_t max)
+{
+    // Deadline "now": whatever is buffered, without waiting
+    int n = stdio_get_until((char *)dst, (int)max, get_absolute_time());
+    return n > 0 ? (size_t)n : 0;
+}
+
+const uint8_t *UsbTransport::peek(size_t &n)
+{
+    if (stage_pos_ == stage_len_)
+    {
+        stage_len_ = (uint32_t)fifo_read_(stage_, sizeof(stage_));
+        stage_pos_ = 0;
+    }
+    n = stage_len_ - stage_pos_;
+    return stage_ + stage_pos_;
+}
+
+void UsbTransport::consume(size_t n)
+{
+    stage_pos_ += (uint32_t)n;
+}
+
+size_t UsbTransport::read(uint8_t *dst, size_t max)
+{
+    // Staged bytes first, then straight from the FIFO
+    size_t got = stage_len_ - stage_pos_;
+    if (got > max)
+        got = max;
+    memcpy(dst, stage_ + stage_pos_, got);
+    stage_pos_ += (uint32_t)got;
+
+    if (got < max)
+        got += fifo_read_(dst + got, max - got);
+    return got;
+}
+
+void UsbTransport::write(const uint8_t *src, size_t n)
+{
+    for (size_t i = 0; i < n; ++i)
+        putchar_raw(src[i]);
+}
+
+void UsbTransport::flush()
+{
+    stdio_flush();
+}
+
+bool UsbTransport::connected() const
+{
+    return stdio_usb_connected();
+}
+
+void UsbTransport::service()
+{
+    track_link_(connected());
+}
+
+void UsbTransport::detach()
+{
+    stage_len_ = stage_pos_ = 0;
+    tud_disconnect();
+}
+
+void UsbTransport::attach()
+{
+    tud_connect();
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "transport.h"
+
+// USB CDC through pico_stdio_usb (the same stream printf goes to). Reads go through
+// stdio's bulk in_chars path, which holds the stdio USB lock against its
+// background tud_task; payloads are copied from the USB FIFO straight into the
+// caller's buffer, headers through a small staging block.
+class UsbTransport : public Transport
+{
+public:
+    // Hooks the stdio chars-available callback (DATA events)
+    void begin();
+
+    const char *name() const override { return "usb"; }
+
+    const uint8_t *peek(size_t &n) override;
+    void consume(size_t n) override;
+    size_t read(uint8_t *dst, size_t max) override;
+
+    void write(const uint8_t *src, size_t n) override;
+    void flush() override;
+    bool connected() const override;
+
+    void service() override;
+    void detach() override;
+    void attach() override;
+
+private:
+    uint8_t stage_[256];
+    uint32_t stage_len_ = 0;
+    uint32_t stage_pos_ = 0;
+
+    size_t fifo_read_(uint8_t *dst, size_t max);
+    static void on_chars_(void *ctx);
+};